@@ -0,0 +1,268 @@
+/**
+ * Purpose: Lookup tables for the squares each piece attacks
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#ifndef ATTACKS_H
+#define ATTACKS_H
+#include <stdint.h>
+#ifdef USE_PEXT
+#include <immintrin.h>
+#endif
+#include "board.h"
+#include "zobrist.h"
+
+// knight and king attacks only depend on the square so they are worked out at compile time
+struct LeaperTables {
+    Bitboard knight[64];
+    Bitboard king[64];
+};
+
+constexpr LeaperTables makeLeaperTables() {
+    // spans are centered on square 18 for knights and 9 for kings, shifting them past the
+    // edge wraps onto the far files so those get masked off
+    constexpr Bitboard KNIGHT_SPAN = 43234889994ULL;
+    constexpr Bitboard KING_SPAN = 460039ULL;
+    constexpr Bitboard FILE_AB = 0x0303030303030303ULL;
+    constexpr Bitboard FILE_GH = 0xC0C0C0C0C0C0C0C0ULL;
+    
+    LeaperTables tables = {};
+    for (int square = 0; square < 64; ++square) {
+        const Bitboard WRAP = square % 8 < 4 ? FILE_GH : FILE_AB;
+        tables.knight[square] = (square > 18 ? KNIGHT_SPAN << (square - 18) : KNIGHT_SPAN >> (18 - square)) & ~WRAP;
+        tables.king[square] = (square > 9 ? KING_SPAN << (square - 9) : KING_SPAN >> (9 - square)) & ~WRAP;
+    }
+    return tables;
+}
+
+inline constexpr LeaperTables LEAPER_ATTACKS = makeLeaperTables();
+
+// bishop and rook attacks for every square and set of blockers. the blockers that matter are
+// hashed to an index by a magic multiply, or by pext when built with -DUSE_PEXT -mbmi2
+class SliderAttacks {
+private:
+    static constexpr Bitboard RANK_MASKS[8] = {
+        0xFF, 0xFF00, 0xFF0000, 0xFF000000, 0xFF00000000, 0xFF0000000000,
+        0xFF000000000000, 0xFF00000000000000
+    };
+    
+    static constexpr Bitboard FILE_MASKS[8] = {
+        0x0101010101010101, 0x0202020202020202, 0x0404040404040404,
+        0x0808080808080808, 0x1010101010101010, 0x2020202020202020,
+        0x4040404040404040, 0x8080808080808080
+    };
+    
+    static constexpr Bitboard DIAGONAL_MASKS1[15] = {
+        0x1L, 0x102L, 0x10204L, 0x1020408L, 0x102040810L, 0x10204081020L,
+        0x1020408102040L, 0x102040810204080L, 0x204081020408000L,
+        0x408102040800000L, 0x810204080000000L, 0x1020408000000000L,
+        0x2040800000000000L, 0x4080000000000000L, 0x8000000000000000L
+    };
+    
+    static constexpr Bitboard DIAGONAL_MASKS2[15] = {
+        0x80L, 0x8040L, 0x804020L, 0x80402010L, 0x8040201008L, 0x804020100804L,
+        0x80402010080402L, 0x8040201008040201L, 0x4020100804020100L,
+        0x2010080402010000L, 0x1008040201000000L, 0x804020100000000L,
+        0x402010000000000L, 0x201000000000000L, 0x100000000000000L
+    };
+    
+    struct Magic {
+        Bitboard mask; // squares whose blockers change the attacks, the board edges never do
+        Bitboard magic;
+        int shift;
+        uint32_t offset; // where this square's attacks start in the table
+        
+        uint32_t index(const Bitboard OCCUPIED) const {
+#ifdef USE_PEXT
+            return offset + _pext_u64(OCCUPIED, mask);
+#else
+            return offset + ((OCCUPIED & mask) * magic >> shift);
+#endif
+        }
+    };
+    
+    // found by trying sparse random numbers from a fixed seed until one mapped every blocker set
+    // of the square without two different attack sets colliding. they only fit this square order
+    static constexpr Bitboard BISHOP_MAGICS[64] = {
+        0x0102040802040020ULL, 0xA108092502020841ULL, 0x804E080109000820ULL, 0x0808061840CA0000ULL,
+        0x81A2121004200420ULL, 0x01A8880540004252ULL, 0x0012080C42C80000ULL, 0x020A020100821042ULL,
+        0x0210102401282220ULL, 0x0000110102041A40ULL, 0x1100080A084610B0ULL, 0x2484180604420020ULL,
+        0x8800020210060000ULL, 0xE020008820091000ULL, 0x0010120202200404ULL, 0x0090202404442420ULL,
+        0x08F04028A0080080ULL, 0x0004000808280865ULL, 0x0002000400220200ULL, 0x003C011090220000ULL,
+        0x0022014402110000ULL, 0x0000400201100101ULL, 0x4004201080945000ULL, 0x0841000A00825120ULL,
+        0x1088C04020041100ULL, 0x2004104020810128ULL, 0x0000480084002400ULL, 0x0182040002010A00ULL,
+        0x2021020044008420ULL, 0xA050002141008802ULL, 0x8522420000980101ULL, 0x0006002886412800ULL,
+        0x80A80840030AA220ULL, 0x0008140440220820ULL, 0x0200104800100080ULL, 0x0100020080880081ULL,
+        0x0040002020120080ULL, 0x2008100100002080ULL, 0x8044212400005410ULL, 0x0098008824810500ULL,
+        0x0402022022200400ULL, 0x0089080202401001ULL, 0x0000C02411021000ULL, 0x040400601800C101ULL,
+        0x4020084101145400ULL, 0x000126480140A200ULL, 0x0008100082010088ULL, 0x2210140110408024ULL,
+        0x0601046120080004ULL, 0x0014A70402200489ULL, 0x000204524C101240ULL, 0x0824060842020038ULL,
+        0x0001014011C3002CULL, 0x0402081001021210ULL, 0x04080230020A0C00ULL, 0x00040410A2020140ULL,
+        0x0030402201202002ULL, 0x1020688080886001ULL, 0x040400002C024802ULL, 0x80042000202A0800ULL,
+        0x980200C021152400ULL, 0xB001002004104080ULL, 0x0001210504008402ULL, 0x1004750802040048ULL
+    };
+    
+    static constexpr Bitboard ROOK_MAGICS[64] = {
+        0x2880004000801020ULL, 0x8300124002208100ULL, 0x0280200010028048ULL, 0x4880080180051000ULL,
+        0x0980080080040012ULL, 0x0200240200700108ULL, 0x0080020000800100ULL, 0x0200002200804411ULL,
+        0x0008800040008030ULL, 0x0003404010002000ULL, 0x0513001300200541ULL, 0x0895000820100100ULL,
+        0x4000800400080080ULL, 0x0008808012002400ULL, 0x4001010402000100ULL, 0x8002000044008201ULL,
+        0x9400888006400021ULL, 0x8020004010002040ULL, 0x0482820022001442ULL, 0x0611030008209002ULL,
+        0x0001010010080004ULL, 0x1002008004008002ULL, 0x000044000908109AULL, 0x08A4420000840041ULL,
+        0x001C400080049020ULL, 0xA002400240201000ULL, 0x00ADA00100110040ULL, 0xA20C090100201000ULL,
+        0x8000040080800800ULL, 0x008A000404001020ULL, 0x2000820400019008ULL, 0x0010084200040089ULL,
+        0x0030400039800280ULL, 0x9A01004001002080ULL, 0x0000801000802000ULL, 0x8800280081803000ULL,
+        0x0000080101000410ULL, 0x0080800400800200ULL, 0x1802010884001002ULL, 0x400A004102000084ULL,
+        0xB008209040008000ULL, 0x001A002100860040ULL, 0x0010402482020014ULL, 0x1030000904110020ULL,
+        0x300C080004008080ULL, 0x0012008004008002ULL, 0x0F00222841240050ULL, 0x4102A09504420004ULL,
+        0x8080024000200140ULL, 0x8040004021048300ULL, 0x0040201040860200ULL, 0x2009002010000900ULL,
+        0x1024110088000500ULL, 0x0012000400028080ULL, 0x4000800100020080ULL, 0x0A08800100006080ULL,
+        0x08B100800C422011ULL, 0x0002400121005083ULL, 0x0006C0081100A003ULL, 0x001009A010000501ULL,
+        0x0802000910200402ULL, 0x032B002204000805ULL, 0x0020300208190084ULL, 0x00010008208A0441ULL
+    };
+    
+    // enough for 2^9 blocker sets or fewer per bishop square and 2^12 or fewer per rook square
+    static constexpr int TABLE_SIZE = 5248 + 102400;
+    
+    Magic bishopMagics[64];
+    Magic rookMagics[64];
+    Bitboard table[TABLE_SIZE];
+    
+    // walk each ray one square at a time, only used to fill the table
+    static Bitboard slidingAttacks(const int SQUARE, const Bitboard OCCUPIED, const bool BISHOP) {
+        const int DIRECTIONS[2][4][2] = {
+            { {1, 0}, {-1, 0}, {0, 1}, {0, -1} },
+            { {1, 1}, {1, -1}, {-1, 1}, {-1, -1} }
+        };
+        Bitboard attacks = 0;
+        for (const auto& DIRECTION : DIRECTIONS[BISHOP]) {
+            for (int x = SQUARE % 8 + DIRECTION[0], y = SQUARE / 8 + DIRECTION[1];
+                    x >= 0 && x < 8 && y >= 0 && y < 8; x += DIRECTION[0], y += DIRECTION[1]) {
+                attacks |= 1ULL << (x + 8 * y);
+                if (OCCUPIED & 1ULL << (x + 8 * y)) {
+                    break;
+                }
+            }
+        }
+        return attacks;
+    }
+    
+    // fill the table for one piece type from every subset of each square's mask
+    void initMagics(Magic magics[64], const bool BISHOP, uint32_t& offset) {
+        for (int square = 0; square < 64; ++square) {
+            Magic& magic = magics[square];
+            const Bitboard EDGES = ((RANK_MASKS[0] | RANK_MASKS[7]) & ~RANK_MASKS[square / 8])
+                | ((FILE_MASKS[0] | FILE_MASKS[7]) & ~FILE_MASKS[square % 8]);
+            magic.mask = slidingAttacks(square, 0, BISHOP) & ~EDGES;
+            magic.magic = BISHOP ? BISHOP_MAGICS[square] : ROOK_MAGICS[square];
+            magic.shift = 64 - __builtin_popcountll(magic.mask);
+            magic.offset = offset;
+            offset += 1 << __builtin_popcountll(magic.mask);
+            
+            // carry rippler, steps through every subset of the mask
+            Bitboard subset = 0;
+            do {
+                table[magic.index(subset)] = slidingAttacks(square, subset, BISHOP);
+                subset = (subset - magic.mask) & magic.mask;
+            } while (subset);
+        }
+    }
+    
+public:
+    SliderAttacks() {
+        uint32_t offset = 0;
+        initMagics(bishopMagics, true, offset);
+        initMagics(rookMagics, false, offset);
+    }
+    
+    Bitboard bishop(const int SQUARE, const Bitboard OCCUPIED) const {
+        return table[bishopMagics[SQUARE].index(OCCUPIED)];
+    }
+    
+    Bitboard rook(const int SQUARE, const Bitboard OCCUPIED) const {
+        return table[rookMagics[SQUARE].index(OCCUPIED)];
+    }
+    
+    // hyperbola quintessence, the table free way attacks used to be found, kept to benchmark against
+    static constexpr Bitboard hypQuint(const Bitboard empty, const Bitboard square, const Bitboard mask) {
+        return ((((mask & ~empty) - (square * 2))
+            ^ reverse(reverse(mask & ~empty) - (reverse(square) * 2))))
+            & mask;
+    }
+    
+    // Reverse function for Hyperbola Quintessence
+    static constexpr Bitboard reverse(Bitboard b) {
+        b = (b & 0x5555555555555555) << 1 | ((b >> 1) & 0x5555555555555555);
+        b = (b & 0x3333333333333333) << 2 | ((b >> 2) & 0x3333333333333333);
+        b = (b & 0x0f0f0f0f0f0f0f0f) << 4 | ((b >> 4) & 0x0f0f0f0f0f0f0f0f);
+        b = (b & 0x00ff00ff00ff00ff) << 8 | ((b >> 8) & 0x00ff00ff00ff00ff);
+        
+        return (b << 48) | ((b & 0xffff0000) << 16) | ((b >> 16) & 0xffff0000) | (b >> 48);
+    }
+    
+    static Bitboard bishopHypQuint(const int SQUARE, const Bitboard OCCUPIED) {
+        const Bitboard PIECE = 1ULL << SQUARE;
+        return hypQuint(~OCCUPIED, PIECE, DIAGONAL_MASKS1[SQUARE / 8 + SQUARE % 8])
+            | hypQuint(~OCCUPIED, PIECE, DIAGONAL_MASKS2[SQUARE / 8 + 7 - SQUARE % 8]);
+    }
+    
+    static Bitboard rookHypQuint(const int SQUARE, const Bitboard OCCUPIED) {
+        const Bitboard PIECE = 1ULL << SQUARE;
+        return hypQuint(~OCCUPIED, PIECE, FILE_MASKS[SQUARE % 8])
+            | hypQuint(~OCCUPIED, PIECE, RANK_MASKS[SQUARE / 8]);
+    }
+    
+    // time table lookups against hyperbola quintessence on random boards and check they agree
+    void benchmark(const int LOOKUPS) const {
+        std::vector<Bitboard> occupancies(4096);
+        uint64_t seed = 1;
+        for (Bitboard& occupied : occupancies) {
+            occupied = nextRandom(seed) & nextRandom(seed);
+        }
+        
+        int mismatches = 0;
+        for (int square = 0; square < 64; ++square) {
+            for (const Bitboard OCCUPIED : occupancies) {
+                mismatches += bishop(square, OCCUPIED) != bishopHypQuint(square, OCCUPIED);
+                mismatches += rook(square, OCCUPIED) != rookHypQuint(square, OCCUPIED);
+            }
+        }
+        
+        // xor every result together so the lookups can't be optimized away
+        Bitboard tableChecksum = 0;
+        Bitboard hypQuintChecksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < LOOKUPS; ++i) {
+            const Bitboard OCCUPIED = occupancies[i & 4095];
+            tableChecksum ^= bishop(i & 63, OCCUPIED) ^ rook(i & 63, OCCUPIED);
+        }
+        const double TABLE_SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < LOOKUPS; ++i) {
+            const Bitboard OCCUPIED = occupancies[i & 4095];
+            hypQuintChecksum ^= bishopHypQuint(i & 63, OCCUPIED) ^ rookHypQuint(i & 63, OCCUPIED);
+        }
+        const double HYP_QUINT_SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+#ifdef USE_PEXT
+        const char* TABLE_NAME = "pext";
+#else
+        const char* TABLE_NAME = "magic";
+#endif
+        std::cout << TABLE_NAME << ": " << TABLE_SECONDS * 1e9 / LOOKUPS << " ns per bishop and rook lookup\n"
+            << "hyperbola quintessence: " << HYP_QUINT_SECONDS * 1e9 / LOOKUPS << " ns per bishop and rook lookup\n"
+            << "speedup " << HYP_QUINT_SECONDS / std::max(TABLE_SECONDS, 1e-9) << ", " << mismatches
+            << " mismatches" << (tableChecksum == hypQuintChecksum ? "" : ", checksums differ") << std::endl;
+    }
+};
+
+inline const SliderAttacks SLIDER_ATTACKS;
+
+#endif
@@ -0,0 +1,196 @@
+/**
+ * Purpose: Analyze a file of EPD positions on a pool of threads and write the results in input order
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#ifndef BATCH_H
+#define BATCH_H
+#include <stdint.h>
+#include "board.h"
+#include "moves.h"
+#include "evaluate.h"
+#include "transposition.h"
+#include "uci.h"
+
+// every worker has its own table and search, so workers never wait on each other except to take
+// the next line and to hand back a result. unlike ParallelSearch the threads speed up the whole
+// file rather than any one position
+class BatchAnalysis {
+private:
+    struct Worker {
+        TranspositionTable table;
+        Evaluate evaluate1;
+        Moves moves1;
+        Position position;
+        
+        Worker(const size_t HASH_MB) : table(HASH_MB), evaluate1(table) {}
+    };
+    
+    std::vector<std::unique_ptr<Worker>> workers;
+    SearchLimits limits;
+    std::ostream* statsLog = nullptr;
+    
+    // lines are numbered as they are read, finished lines wait here until every line before them is written
+    std::mutex mutex;
+    uint64_t nextRead = 0;
+    uint64_t nextWrite = 0;
+    std::map<uint64_t, std::string> finished;
+    uint64_t totalNodes = 0;
+    
+    // a missing or extra king or a side to move that could take the king would break the search
+    static bool isLegalSetup(Moves& moves1, Position position) {
+        if (__builtin_popcountll(position.pieces[WHITE_KING]) != 1 || __builtin_popcountll(position.pieces[BLACK_KING]) != 1) {
+            return false;
+        }
+        position.whiteTurn = !position.whiteTurn;
+        return !moves1.inCheck(position);
+    }
+    
+    // the four position fields with the original operations, then the engine's move under pm since
+    // bm in test suites is the expected answer, the score from the side to move as ce, or dm when
+    // it mates, and depth, nodes and seconds as acd, acn and acs
+    std::string analyze(Worker& worker, const std::string& LINE, uint64_t& nodes) {
+        std::istringstream fields(LINE);
+        std::string placement, turn, castles, enPassant;
+        if (!(fields >> placement >> turn >> castles >> enPassant)) {
+            return LINE;
+        }
+        std::string epd = placement + " " + turn + " " + castles + " " + enPassant;
+        
+        // FEN style move counters may follow the four fields, everything after them is operations
+        std::string fen = epd;
+        for (int counter = 0; counter < 2; ++counter) {
+            const auto BEFORE = fields.tellg();
+            std::string token;
+            if (!(fields >> token) || token.find_first_not_of("0123456789") != std::string::npos) {
+                fields.clear();
+                fields.seekg(BEFORE);
+                break;
+            }
+            fen += " " + token;
+        }
+        std::string operations;
+        std::getline(fields, operations);
+        operations.erase(0, operations.find_first_not_of(" \t"));
+        operations.erase(operations.find_last_not_of(" \t\r") + 1);
+        if (!operations.empty()) {
+            epd += " " + operations;
+        }
+        
+        worker.position = Board::fenToPosition(fen);
+        if (!isLegalSetup(worker.moves1, worker.position)) {
+            return epd + " c0 \"illegal position\";";
+        }
+        
+        // each line decides for itself, so a file can mix standard and chess960 positions
+        const bool CHESS960 = Board::isChess960(worker.position);
+        worker.table.clear();
+        const auto START = std::chrono::steady_clock::now();
+        const Move MOVE = worker.evaluate1.search(limits, worker.moves1, worker.position);
+        const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+        nodes = worker.evaluate1.getNodes() + worker.evaluate1.getQNodes();
+        if (statsLog) {
+            const std::string JSON = worker.evaluate1.getStats().toJson(1, worker.evaluate1.getCompletedDepth(),
+                worker.evaluate1.getBestScore(), moveToAlgebraic(MOVE, CHESS960), SECONDS);
+            std::lock_guard<std::mutex> lock(mutex);
+            *statsLog << JSON << "\n";
+        }
+        if (MOVE == NULL_MOVE) {
+            return epd + " c0 \"no legal moves\";";
+        }
+        
+        std::ostringstream result;
+        result << epd;
+        const Score SCORE = worker.position.whiteTurn ? worker.evaluate1.getBestScore() : -worker.evaluate1.getBestScore();
+        result << " pm " << moveToAlgebraic(MOVE, CHESS960) << ";";
+        if (SCORE >= MATE_BOUND) {
+            result << " dm " << (MATE_SCORE - SCORE + 1) / 2 << ";";
+        } else {
+            result << " ce " << SCORE << ";";
+        }
+        result << " acd " << worker.evaluate1.getCompletedDepth() << "; acn " << nodes << "; acs "
+            << std::fixed << std::setprecision(3) << SECONDS << ";";
+        return result.str();
+    }
+    
+    void work(Worker& worker, std::istream& input, std::ostream& output) {
+        std::string line;
+        while (true) {
+            uint64_t index;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!std::getline(input, line)) {
+                    return;
+                }
+                index = nextRead++;
+            }
+            
+            // blank lines and comments go back out unchanged so the output lines up with the input
+            uint64_t nodes = 0;
+            const bool SKIP = line.find_first_not_of(" \t\r") == std::string::npos || line[line.find_first_not_of(" \t")] == '#';
+            std::string result = SKIP ? line : analyze(worker, line, nodes);
+            
+            std::lock_guard<std::mutex> lock(mutex);
+            totalNodes += nodes;
+            finished[index] = std::move(result);
+            for (auto it = finished.find(nextWrite); it != finished.end(); it = finished.find(++nextWrite)) {
+                output << it->second << "\n";
+                finished.erase(it);
+            }
+        }
+    }
+    
+public:
+    // THREADS workers with a HASH_MB table each, so THREADS times HASH_MB in all. splitting the hash
+    // between them would make a line's result depend on how many threads run
+    BatchAnalysis(const int THREADS, const size_t HASH_MB, const SearchOptions& OPTIONS) : statsLog(OPTIONS.statsLog) {
+        const int COUNT = std::max(1, THREADS);
+        for (int i = 0; i < COUNT; ++i) {
+            workers.push_back(std::make_unique<Worker>(HASH_MB));
+            workers.back()->evaluate1.setOptions(OPTIONS);
+        }
+    }
+    
+    // analyze every line of input within LIMITS and write one line of output for each, the table is
+    // cleared before each position so a line's result doesn't depend on which worker took it or
+    // what it searched before. the totals go to the error stream so they don't mix with the results
+    void run(std::istream& input, std::ostream& output, const SearchLimits& LIMITS) {
+        limits = LIMITS;
+        nextRead = 0;
+        nextWrite = 0;
+        totalNodes = 0;
+        const auto START = std::chrono::steady_clock::now();
+        
+        std::vector<std::thread> threads;
+        for (std::unique_ptr<Worker>& worker : workers) {
+            threads.emplace_back([this, &worker, &input, &output] { work(*worker, input, output); });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        output.flush();
+        if (statsLog) {
+            statsLog->flush();
+        }
+        
+        const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+        std::cerr << nextWrite << " lines, " << workers.size() << " threads, " << std::fixed << std::setprecision(3)
+            << SECONDS << "s, " << totalNodes << " nodes, " << static_cast<uint64_t>(totalNodes / std::max(SECONDS, 1e-9))
+            << " nps" << std::endl;
+    }
+};
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * Purpose: Search a fixed set of positions to a fixed depth for a node count signature and a speed figure
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#ifndef BENCH_H
+#define BENCH_H
+#include <stdint.h>
+#include "board.h"
+#include "evaluate.h"
+#include "transposition.h"
+#include "smp.h"
+#include "book.h"
+
+class Bench {
+private:
+    // middlegames, endgames and chess960 starts, changing this list changes the signature
+    inline static const std::vector<std::string> POSITIONS = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1BBPPP/R2QK2R w KQ - 4 9",
+        "rnbqk2r/ppp1bppp/4pn2/3p4/2PP4/5NP1/PP2PPBP/RNBQK2R b KQkq - 1 5",
+        "r2q1rk1/pb1nbppp/1p2pn2/2pp4/2PP4/1PN1PN2/PB2BPPP/R2Q1RK1 w - - 0 10",
+        "2rq1rk1/pp1bppbp/3p1np1/4n3/3NP3/1BN1BP2/PPPQ2PP/2KR3R w - - 8 13",
+        "r1b2rk1/2q1bppp/p2ppn2/1p6/3BPP2/2NB4/PPPQ2PP/2KR3R w - - 2 14",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "8/8/4k3/3p4/3P1K2/8/8/8 w - - 0 1",
+        "6k1/5p2/6p1/8/7p/8/6PP/6K1 b - - 0 1",
+        "8/5pk1/6p1/3R4/7P/6P1/r4PK1/8 w - - 0 40",
+        "8/8/8/4k3/8/8/3QK3/8 w - - 0 1",
+        "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9",
+        "nrbqkbrn/pppppppp/8/8/8/8/PPPPPPPP/NRBQKBRN w GBgb - 0 1",
+        "qrnbbkrn/pppppppp/8/8/8/8/PPPPPPPP/QRNBBKRN w GBgb - 0 1"
+    };
+    
+    // probes each position after the first this many times, enough for the clock to resolve
+    static constexpr int BOOK_PROBES = 10000;
+    
+    // time looking every position up in the book. the first probe of a position may have to fault
+    // its pages in from the file so it is timed apart from the ones after it that find them cached
+    static void probeBook(PolyglotBook& book) {
+        Moves moves1;
+        int hits = 0;
+        double coldSeconds = 0;
+        double warmSeconds = 0;
+        for (const std::string& FEN : POSITIONS) {
+            const Position POSITION = Board::fenToPosition(FEN);
+            auto start = std::chrono::steady_clock::now();
+            hits += book.probe(moves1, POSITION, BOOK_BEST) != NULL_MOVE;
+            coldSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            
+            start = std::chrono::steady_clock::now();
+            for (int i = 0; i < BOOK_PROBES; ++i) {
+                book.probe(moves1, POSITION, BOOK_BEST);
+            }
+            warmSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        std::cout << "Book: " << book.size() << " entries, " << hits << "/" << POSITIONS.size() << " positions found\n"
+            << "Book probe: " << static_cast<uint64_t>(coldSeconds * 1e9 / POSITIONS.size()) << " ns first, "
+            << static_cast<uint64_t>(warmSeconds * 1e9 / (POSITIONS.size() * BOOK_PROBES)) << " ns after" << std::endl;
+    }
+    
+public:
+    // search every position to DEPTH with a cleared table and print the total node count, which only
+    // changes when the search does, and the speed. with more than one thread the threads race so the
+    // count varies from run to run. the search never uses the book, with one open its probe time is
+    // printed after the totals
+    static void run(const int DEPTH, const int THREADS, const size_t HASH_MB, const SearchOptions& OPTIONS, PolyglotBook& book) {
+        TranspositionTable table(HASH_MB);
+        ParallelSearch search1(table, THREADS);
+        SearchOptions options = OPTIONS;
+        SearchLimits limits;
+        limits.depth = DEPTH;
+        
+        uint64_t totalNodes = 0;
+        double totalSeconds = 0;
+        for (size_t i = 0; i < POSITIONS.size(); ++i) {
+            // only the chess960 starts log castles as the king taking its rook
+            const Position POSITION = Board::fenToPosition(POSITIONS[i]);
+            options.chess960 = Board::isChess960(POSITION);
+            search1.setOptions(options);
+            table.clear();
+            const auto START = std::chrono::steady_clock::now();
+            search1.search(limits, POSITION);
+            totalSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+            totalNodes += search1.getNodes();
+            std::cout << "Position " << std::setw(2) << i + 1 << "/" << POSITIONS.size() << ": "
+                << search1.getNodes() << " nodes\n";
+        }
+        
+        std::cout << "Depth " << DEPTH << ", " << THREADS << " threads, " << HASH_MB << " MB hash\n"
+            << "Nodes: " << totalNodes << "\nTime: " << static_cast<uint64_t>(totalSeconds * 1000) << " ms\n"
+            << "NPS: " << static_cast<uint64_t>(totalNodes / std::max(totalSeconds, 1e-9)) << std::endl;
+        if (book.isOpen()) {
+            probeBook(book);
+        }
+    }
+};
+
+#endif
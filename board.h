@@ -17,26 +17,257 @@
 #define BOARD_H
 #include <stdint.h>
 #include <iomanip>
+#include "zobrist.h"
+#include "psqt.h"
 
 typedef uint64_t Bitboard;
 
-// bitboard for en passant location
-static Bitboard enPassant;
+// indexes into the position piece bitboards, white pieces come first
+enum Piece {
+    WHITE_PAWN, WHITE_KNIGHT, WHITE_BISHOP, WHITE_ROOK, WHITE_QUEEN, WHITE_KING,
+    BLACK_PAWN, BLACK_KNIGHT, BLACK_BISHOP, BLACK_ROOK, BLACK_QUEEN, BLACK_KING,
+    NO_PIECE
+};
+
+// bits of the position castle rights
+enum CastleRight {
+    WHITE_SHORT_CASTLE = 1, WHITE_LONG_CASTLE = 2,
+    BLACK_SHORT_CASTLE = 4, BLACK_LONG_CASTLE = 8
+};
+
+constexpr bool isWhitePiece(const int PIECE) {
+    return PIECE < BLACK_PAWN;
+}
+
+constexpr bool isPawn(const int PIECE) {
+    return PIECE == WHITE_PAWN || PIECE == BLACK_PAWN;
+}
+
+// most moves a game and search can reach, sizes the undo stack
+const int MAX_HISTORY = 2048;
+
+// plies a search may add to the undo stack, quiescence stops there. a game keeps its history
+// below MAX_GAME_HISTORY so a search always fits on top of it
+const int MAX_SEARCH_PLIES = 256;
+const int MAX_GAME_HISTORY = MAX_HISTORY - MAX_SEARCH_PLIES;
 
-// bitboards for every piece type
-static Bitboard whitePawns;
-static Bitboard whiteKnights;
-static Bitboard whiteBishops;
-static Bitboard whiteRooks;
-static Bitboard whiteQueens;
-static Bitboard whiteKing;
+// scores are whole hundredths of a pawn. a mate is MATE_SCORE less the plies from the root to it,
+// so shorter mates score higher and every mate is beyond MATE_BOUND
+typedef int Score;
+const Score MATE_SCORE = 32000;
+const Score INFINITE_SCORE = MATE_SCORE + 1;
+const Score MATE_BOUND = MATE_SCORE - MAX_HISTORY;
 
-static Bitboard blackPawns;
-static Bitboard blackKnights;
-static Bitboard blackBishops;
-static Bitboard blackRooks;
-static Bitboard blackQueens;
-static Bitboard blackKing;
+// the transposition table keeps mates as plies from the stored position instead of from the root,
+// so they stay right when the position comes up again at another ply
+constexpr Score scoreToTable(const Score SCORE, const int PLY) {
+    return SCORE >= MATE_BOUND ? SCORE + PLY : SCORE <= -MATE_BOUND ? SCORE - PLY : SCORE;
+}
+
+constexpr Score scoreFromTable(const Score SCORE, const int PLY) {
+    return SCORE >= MATE_BOUND ? SCORE - PLY : SCORE <= -MATE_BOUND ? SCORE + PLY : SCORE;
+}
+
+// pawns with two decimals, or the moves to mate with a minus when the mate is against white
+inline std::string scoreToString(const Score SCORE) {
+    if (std::abs(SCORE) >= MATE_BOUND) {
+        const int MOVES = (MATE_SCORE - std::abs(SCORE) + 1) / 2;
+        return (SCORE < 0 ? "mate -" : "mate ") + std::to_string(MOVES);
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << SCORE / 100.0;
+    return out.str();
+}
+
+// state that a move destroys and undoing it needs back
+struct UndoData {
+    int capturedPiece;
+    int castleRights;
+    int halfmoveClock;
+    Bitboard enPassant;
+    uint64_t key; // key before the move, so the stack doubles as the history of earlier positions
+};
+
+// everything needed to describe one position, so many can exist at once
+struct Position {
+    // bitboards for every piece type, indexed by Piece
+    Bitboard pieces[12] = {};
+    
+    // cached occupancy for each color
+    Bitboard whitePieces = 0;
+    Bitboard blackPieces = 0;
+    
+    // bitboard for en passant location
+    Bitboard enPassant = 0;
+    
+    bool whiteTurn = true;
+    int castleRights = 0;
+    
+    // plies since the last capture or pawn move, nothing before that can repeat
+    int halfmoveClock = 0;
+    
+    // counts up after every black move, only kept so FEN can be written back out
+    int fullmoveNumber = 1;
+    
+    // zobrist hash, kept up to date by every change to the position
+    uint64_t key = 0;
+    
+    // zobrist hash of the pawns alone, so pawn structure can be cached apart from the rest
+    uint64_t pawnKey = 0;
+    
+    // evaluation terms kept up to date the same way, from white's side. material and placement
+    // for the middlegame and endgame are in hundredths of a pawn, and phase falls from
+    // MAX_PHASE as pieces come off
+    int material = 0;
+    int middlegamePlacement = 0;
+    int endgamePlacement = 0;
+    int phase = 0;
+    
+    // starting rooks used for castling, these can be on any file in chess960
+    Bitboard whiteLeftRook = 0;
+    Bitboard whiteRightRook = 0;
+    Bitboard blackLeftRook = 0;
+    Bitboard blackRightRook = 0;
+    
+    // piece on every square, NO_PIECE if empty
+    uint8_t mailbox[64];
+    
+    // preallocated so making moves never allocates
+    UndoData undoStack[MAX_HISTORY];
+    int undoSize = 0;
+    
+    Position() {
+        std::fill(std::begin(mailbox), std::end(mailbox), NO_PIECE);
+    }
+    
+    Bitboard occupied() const {
+        return whitePieces | blackPieces;
+    }
+    
+    // whether this position came up before with the same side to move, looking back only as far
+    // as the last capture or pawn move. a repeat at or after SEARCH_ROOT counts at once since whoever
+    // repeated can do it again, older positions must have come up twice for a threefold repetition
+    bool isRepetition(const int SEARCH_ROOT) const {
+        const int OLDEST = std::max(0, undoSize - halfmoveClock);
+        int count = 0;
+        for (int i = undoSize - 4; i >= OLDEST; i -= 2) {
+            if (undoStack[i].key == key && (i >= SEARCH_ROOT || ++count == 2)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // drop the oldest half of the history once a game reaches MAX_GAME_HISTORY. only moves since
+    // the last capture or pawn move can repeat, so nothing a search looks at is lost unless the game
+    // went on a thousand plies without one
+    void trimHistory() {
+        if (undoSize >= MAX_GAME_HISTORY) {
+            const int KEEP = MAX_GAME_HISTORY / 2;
+            std::copy(undoStack + undoSize - KEEP, undoStack + undoSize, undoStack);
+            undoSize = KEEP;
+        }
+    }
+    
+    void addPiece(const int PIECE, const int SQUARE) {
+        const Bitboard MASK = 1ULL << SQUARE;
+        pieces[PIECE] |= MASK;
+        (isWhitePiece(PIECE) ? whitePieces : blackPieces) |= MASK;
+        mailbox[SQUARE] = PIECE;
+        key ^= ZOBRIST.pieces[PIECE][SQUARE];
+        if (isPawn(PIECE)) {
+            pawnKey ^= ZOBRIST.pieces[PIECE][SQUARE];
+        }
+        material += PIECE_VALUES[PIECE];
+        middlegamePlacement += PLACEMENT.middlegame[PIECE * 64 + SQUARE];
+        endgamePlacement += PLACEMENT.endgame[PIECE * 64 + SQUARE];
+        phase += PHASE_WEIGHTS[PIECE];
+    }
+    
+    void removePiece(const int SQUARE) {
+        const int PIECE = mailbox[SQUARE];
+        const Bitboard MASK = 1ULL << SQUARE;
+        pieces[PIECE] ^= MASK;
+        (isWhitePiece(PIECE) ? whitePieces : blackPieces) ^= MASK;
+        mailbox[SQUARE] = NO_PIECE;
+        key ^= ZOBRIST.pieces[PIECE][SQUARE];
+        if (isPawn(PIECE)) {
+            pawnKey ^= ZOBRIST.pieces[PIECE][SQUARE];
+        }
+        material -= PIECE_VALUES[PIECE];
+        middlegamePlacement -= PLACEMENT.middlegame[PIECE * 64 + SQUARE];
+        endgamePlacement -= PLACEMENT.endgame[PIECE * 64 + SQUARE];
+        phase -= PHASE_WEIGHTS[PIECE];
+    }
+    
+    void movePiece(const int START, const int END) {
+        const int PIECE = mailbox[START];
+        const Bitboard MASK = 1ULL << START | 1ULL << END;
+        pieces[PIECE] ^= MASK;
+        (isWhitePiece(PIECE) ? whitePieces : blackPieces) ^= MASK;
+        mailbox[START] = NO_PIECE;
+        mailbox[END] = PIECE;
+        key ^= ZOBRIST.pieces[PIECE][START] ^ ZOBRIST.pieces[PIECE][END];
+        if (isPawn(PIECE)) {
+            pawnKey ^= ZOBRIST.pieces[PIECE][START] ^ ZOBRIST.pieces[PIECE][END];
+        }
+        middlegamePlacement += PLACEMENT.middlegame[PIECE * 64 + END] - PLACEMENT.middlegame[PIECE * 64 + START];
+        endgamePlacement += PLACEMENT.endgame[PIECE * 64 + END] - PLACEMENT.endgame[PIECE * 64 + START];
+    }
+    
+    // key of the castle rights, each right hashes the file of its rook so chess960 setups differ
+    uint64_t castleKey() const {
+        uint64_t castles = 0;
+        if (castleRights & WHITE_SHORT_CASTLE) {castles ^= ZOBRIST.castles[0][__builtin_ctzll(whiteRightRook) % 8];}
+        if (castleRights & WHITE_LONG_CASTLE) {castles ^= ZOBRIST.castles[0][__builtin_ctzll(whiteLeftRook) % 8];}
+        if (castleRights & BLACK_SHORT_CASTLE) {castles ^= ZOBRIST.castles[1][__builtin_ctzll(blackRightRook) % 8];}
+        if (castleRights & BLACK_LONG_CASTLE) {castles ^= ZOBRIST.castles[1][__builtin_ctzll(blackLeftRook) % 8];}
+        return castles;
+    }
+    
+    uint64_t enPassantKey() const {
+        return enPassant ? ZOBRIST.enPassant[__builtin_ctzll(enPassant) % 8] : 0;
+    }
+    
+    // full recompute of the key, used to set up positions and to check the incremental key
+    uint64_t computeKey() const {
+        uint64_t fullKey = castleKey() ^ enPassantKey() ^ (whiteTurn ? 0 : ZOBRIST.blackTurn);
+        for (int square = 0; square < 64; ++square) {
+            if (mailbox[square] != NO_PIECE) {
+                fullKey ^= ZOBRIST.pieces[mailbox[square]][square];
+            }
+        }
+        return fullKey;
+    }
+    
+    uint64_t computePawnKey() const {
+        uint64_t fullKey = 0;
+        for (int square = 0; square < 64; ++square) {
+            if (mailbox[square] != NO_PIECE && isPawn(mailbox[square])) {
+                fullKey ^= ZOBRIST.pieces[mailbox[square]][square];
+            }
+        }
+        return fullKey;
+    }
+    
+    // full recompute of the evaluation terms, used to check the incremental ones
+    bool scoresMatchBoard() const {
+        int fullMaterial = 0;
+        int fullMiddlegame = 0;
+        int fullEndgame = 0;
+        int fullPhase = 0;
+        for (int square = 0; square < 64; ++square) {
+            if (mailbox[square] != NO_PIECE) {
+                fullMaterial += PIECE_VALUES[mailbox[square]];
+                fullMiddlegame += PLACEMENT.middlegame[mailbox[square] * 64 + square];
+                fullEndgame += PLACEMENT.endgame[mailbox[square] * 64 + square];
+                fullPhase += PHASE_WEIGHTS[mailbox[square]];
+            }
+        }
+        return fullMaterial == material && fullMiddlegame == middlegamePlacement
+            && fullEndgame == endgamePlacement && fullPhase == phase;
+    }
+};
 
 class Board {
 private:
@@ -53,72 +284,217 @@ private:
     };
     
 public:
-    Board(const char gameType) {
+    Board(const bool CHESS960) {
         // if playing chess960, shuffle rank1 and rank8 the same way
-        if (gameType == 'H') {
-            char pieces[8] = { 'R', 'N', 'B', 'Q', 'K', 'B', 'N', 'R' };
-            std::srand(static_cast<unsigned int>(std::time(nullptr)));
-            std::random_shuffle(std::begin(pieces), std::end(pieces));
+        if (CHESS960) {
+            char pieces[8];
+            chess960Shuffle(pieces);
             for (int i = 0; i < 8; ++i) {
                 chessBoard[7][i] = pieces[i];
                 chessBoard[0][i] = tolower(pieces[i]);
             }
         }
-        arrayToBitboard();
     }
     
-    // cycles through every part of array and sets up bitboards
-    void arrayToBitboard() {
+    // random chess960 back rank, bishops on opposite colors and the king between the rooks
+    void chess960Shuffle(char pieces[8]) {
+        std::mt19937 random(static_cast<unsigned int>(std::time(nullptr)));
+        std::fill(pieces, pieces + 8, ' ');
+        pieces[2 * (random() % 4)] = 'B';
+        pieces[2 * (random() % 4) + 1] = 'B';
+        
+        // queen and knights go on random empty squares, then rook, king, rook fill the rest in order
+        const char ORDER[6] = { 'Q', 'N', 'N', 'R', 'K', 'R' };
+        for (int i = 0; i < 6; ++i) {
+            int empty = i < 3 ? random() % (6 - i) : 0;
+            for (int square = 0; square < 8; ++square) {
+                if (pieces[square] == ' ' && empty-- == 0) {
+                    pieces[square] = ORDER[i];
+                    break;
+                }
+            }
+        }
+    }
+    
+    // cycles through every part of array and sets up bitboards of a new position
+    Position arrayToPosition() {
+        const std::string PIECE_CHARS = "PNBRQKpnbrqk";
+        Position position;
         for (int rank = 0; rank < 8; ++rank) {
             for (int file = 0; file < 8; ++file) {
-                int index = rank * 8 + file;
-                const Bitboard mask = 1ULL << index;
-                
-                switch (chessBoard[rank][file]) {
-                    case 'P': whitePawns |= mask; break;
-                    case 'N': whiteKnights |= mask; break;
-                    case 'B': whiteBishops |= mask; break;
-                    case 'R': whiteRooks |= mask; break;
-                    case 'Q': whiteQueens |= mask; break;
-                    case 'K': whiteKing |= mask; break;
-                    case 'p': blackPawns |= mask; break;
-                    case 'n': blackKnights |= mask; break;
-                    case 'b': blackBishops |= mask; break;
-                    case 'r': blackRooks |= mask; break;
-                    case 'q': blackQueens |= mask; break;
-                    case 'k': blackKing |= mask; break;
+                const size_t PIECE = PIECE_CHARS.find(chessBoard[rank][file]);
+                if (PIECE != std::string::npos) {
+                    position.addPiece(PIECE, rank * 8 + file);
+                }
+            }
+        }
+        
+        // castling is legal at the start of games
+        position.castleRights = WHITE_SHORT_CASTLE | WHITE_LONG_CASTLE | BLACK_SHORT_CASTLE | BLACK_LONG_CASTLE;
+        const Bitboard WHITE_ROOKS = position.pieces[WHITE_ROOK];
+        const Bitboard BLACK_ROOKS = position.pieces[BLACK_ROOK];
+        position.whiteLeftRook = WHITE_ROOKS & -WHITE_ROOKS;
+        position.whiteRightRook = WHITE_ROOKS ^ position.whiteLeftRook;
+        position.blackLeftRook = BLACK_ROOKS & -BLACK_ROOKS;
+        position.blackRightRook = BLACK_ROOKS ^ position.blackLeftRook;
+        position.key = position.computeKey();
+        position.pawnKey = position.computePawnKey();
+        return position;
+    }
+    
+    // set up a position from FEN, castle rights can be KQkq or the chess960 rook files like HAha
+    static Position fenToPosition(const std::string& FEN) {
+        const std::string PIECE_CHARS = "PNBRQKpnbrqk";
+        std::istringstream fields(FEN);
+        std::string placement, turn, castles, enPassant;
+        int halfmoveClock = 0;
+        int fullmoveNumber = 1;
+        fields >> placement >> turn >> castles >> enPassant >> halfmoveClock >> fullmoveNumber;
+        
+        Position position;
+        int square = 0;
+        for (const char C : placement) {
+            if (C == '/') {
+                continue;
+            } else if (C >= '1' && C <= '8') {
+                square += C - '0';
+            } else if (PIECE_CHARS.find(C) != std::string::npos && square < 64) {
+                position.addPiece(PIECE_CHARS.find(C), square++);
+            }
+        }
+        position.whiteTurn = turn != "b";
+        position.halfmoveClock = std::max(0, halfmoveClock);
+        position.fullmoveNumber = std::max(1, fullmoveNumber);
+        
+        // K and Q pick the outermost rook on that side of the king, a right without its king or rook
+        // on the back rank is dropped
+        for (const char C : castles) {
+            const bool WHITE = std::isupper(C);
+            const int BACK_RANK = WHITE ? 56 : 0;
+            const Bitboard ROOKS = position.pieces[WHITE ? WHITE_ROOK : BLACK_ROOK] & (0xFFULL << BACK_RANK);
+            const Bitboard KING = position.pieces[WHITE ? WHITE_KING : BLACK_KING] & (0xFFULL << BACK_RANK);
+            if (!ROOKS || !KING) {
+                continue;
+            }
+            const int KING_LOC = __builtin_ctzll(KING);
+            int rookLoc;
+            if (std::toupper(C) == 'K') {
+                rookLoc = 63 - __builtin_clzll(ROOKS);
+            } else if (std::toupper(C) == 'Q') {
+                rookLoc = __builtin_ctzll(ROOKS);
+            } else if (std::toupper(C) >= 'A' && std::toupper(C) <= 'H') {
+                rookLoc = BACK_RANK + std::toupper(C) - 'A';
+            } else {
+                continue;
+            }
+            if (!(ROOKS & 1ULL << rookLoc)) {
+                continue;
+            }
+            
+            const bool SHORT = rookLoc > KING_LOC;
+            if (WHITE) {
+                (SHORT ? position.whiteRightRook : position.whiteLeftRook) = 1ULL << rookLoc;
+                position.castleRights |= SHORT ? WHITE_SHORT_CASTLE : WHITE_LONG_CASTLE;
+            } else {
+                (SHORT ? position.blackRightRook : position.blackLeftRook) = 1ULL << rookLoc;
+                position.castleRights |= SHORT ? BLACK_SHORT_CASTLE : BLACK_LONG_CASTLE;
+            }
+        }
+        
+        // FEN gives the square behind the pawn, the position stores the pawn itself
+        if (enPassant.length() == 2) {
+            const int TARGET = enPassant[0] - 'a' + 8 * ('8' - enPassant[1]);
+            position.enPassant = 1ULL << (position.whiteTurn ? TARGET + 8 : TARGET - 8);
+        }
+        position.key = position.computeKey();
+        position.pawnKey = position.computePawnKey();
+        return position;
+    }
+    
+    // whether a king or rook with castle rights is off its standard square, so castles need chess960
+    // notation to tell them apart from king moves
+    static bool isChess960(const Position& position) {
+        const bool WHITE_KING_HOME = position.pieces[WHITE_KING] == 1ULL << 60;
+        const bool BLACK_KING_HOME = position.pieces[BLACK_KING] == 1ULL << 4;
+        return ((position.castleRights & WHITE_SHORT_CASTLE) && (!WHITE_KING_HOME || position.whiteRightRook != 1ULL << 63))
+            || ((position.castleRights & WHITE_LONG_CASTLE) && (!WHITE_KING_HOME || position.whiteLeftRook != 1ULL << 56))
+            || ((position.castleRights & BLACK_SHORT_CASTLE) && (!BLACK_KING_HOME || position.blackRightRook != 1ULL << 7))
+            || ((position.castleRights & BLACK_LONG_CASTLE) && (!BLACK_KING_HOME || position.blackLeftRook != 1ULL << 0));
+    }
+    
+    // write a position as FEN. castle rights use KQkq when the rook is the outermost one on its side
+    // of the king and the rook's file otherwise, so chess960 positions read back the same
+    static std::string positionToFen(const Position& position) {
+        const char PIECE_CHARS[12] = { 'P', 'N', 'B', 'R', 'Q', 'K', 'p', 'n', 'b', 'r', 'q', 'k' };
+        std::string fen;
+        for (int row = 0; row < 8; ++row) {
+            int empty = 0;
+            for (int square = 8 * row; square < 8 * row + 8; ++square) {
+                if (position.mailbox[square] == NO_PIECE) {
+                    ++empty;
+                    continue;
+                }
+                if (empty) {
+                    fen += char('0' + empty);
+                    empty = 0;
                 }
+                fen += PIECE_CHARS[position.mailbox[square]];
+            }
+            if (empty) {
+                fen += char('0' + empty);
             }
+            fen += row < 7 ? "/" : "";
         }
+        fen += position.whiteTurn ? " w " : " b ";
+        
+        const struct { int right; Bitboard rook; bool white; bool outermost; } CASTLES[4] = {
+            { WHITE_SHORT_CASTLE, position.whiteRightRook, true, true },
+            { WHITE_LONG_CASTLE, position.whiteLeftRook, true, false },
+            { BLACK_SHORT_CASTLE, position.blackRightRook, false, true },
+            { BLACK_LONG_CASTLE, position.blackLeftRook, false, false }
+        };
+        const size_t CASTLE_START = fen.size();
+        for (const auto& CASTLE : CASTLES) {
+            if (!(position.castleRights & CASTLE.right) || !CASTLE.rook) {
+                continue;
+            }
+            const int ROOK_LOC = __builtin_ctzll(CASTLE.rook);
+            const Bitboard ROOKS = position.pieces[CASTLE.white ? WHITE_ROOK : BLACK_ROOK] & (0xFFULL << (ROOK_LOC & 56));
+            const int OUTERMOST = CASTLE.outermost ? 63 - __builtin_clzll(ROOKS) : __builtin_ctzll(ROOKS);
+            const char LETTER = OUTERMOST == ROOK_LOC ? (CASTLE.outermost ? 'k' : 'q') : char('a' + ROOK_LOC % 8);
+            fen += CASTLE.white ? char(std::toupper(LETTER)) : LETTER;
+        }
+        fen += fen.size() == CASTLE_START ? "- " : " ";
+        
+        // the position keeps the pawn that can be taken, FEN the square behind it
+        if (position.enPassant) {
+            const int TARGET = __builtin_ctzll(position.enPassant) + (position.whiteTurn ? -8 : 8);
+            fen += { char('a' + TARGET % 8), char('8' - TARGET / 8) };
+        } else {
+            fen += "-";
+        }
+        return fen + " " + std::to_string(position.halfmoveClock) + " " + std::to_string(position.fullmoveNumber);
     }
     
-    void displayBoard(const int HALF_TURNS, const int MATERIAL, const float SCORE) {
+    void displayBoard(const Position& position, const int HALF_TURNS, const Score MATERIAL, const Score SCORE) {
+        const char* PIECE_NAMES[13] = {
+            "WP", "WN", "WB", "WR", "WQ", "WK", "bp", "bn", "bb", "br", "bq", "bk", "  "
+        };
+        
         std::cout << "\n     0    1    2    3    4    5    6    7\n"
             << "  |----|----|----|----|----|----|----|----|\n";
         
         for (int i = 0; i < 64; ++i) {
             if (i % 8 == 0) {std::cout << (7 - i / 8) << " ";}
             
-            if ((whitePawns >> i) & 1 == 1) {std::cout << "| WP ";}
-            else if ((whiteKnights >> i) & 1 == 1) {std::cout << "| WN ";}
-            else if ((whiteBishops >> i) & 1 == 1) {std::cout << "| WB ";}
-            else if ((whiteRooks >> i) & 1 == 1) {std::cout << "| WR ";}
-            else if ((whiteQueens >> i) & 1 == 1) {std::cout << "| WQ ";}
-            else if ((whiteKing >> i) & 1 == 1) {std::cout << "| WK ";}
-            else if ((blackPawns >> i) & 1 == 1) {std::cout << "| bp ";}
-            else if ((blackKnights >> i) & 1 == 1) {std::cout << "| bn ";}
-            else if ((blackBishops >> i) & 1 == 1) {std::cout << "| bb ";}
-            else if ((blackRooks >> i) & 1 == 1) {std::cout << "| br ";}
-            else if ((blackQueens >> i) & 1 == 1) {std::cout << "| bq ";}
-            else if ((blackKing >> i) & 1 == 1) {std::cout << "| bk ";}
-            else {std::cout << "|    ";}
+            std::cout << "| " << PIECE_NAMES[position.mailbox[i]] << " ";
             
             if (i % 8 == 7) {std::cout << "| " << (7 - i / 8)
                 << "\n  |----|----|----|----|----|----|----|----|\n";}
         } std::cout << "     0    1    2    3    4    5    6    7\n"
             << "Turn: " << (HALF_TURNS / 2) << (HALF_TURNS % 2 == 0 ? "" : ".5")
-            << ", Material: " << MATERIAL
-            << ", Score: " << std::fixed << std::setprecision(1) << SCORE << "\n" << std::endl;
+            << ", Material: " << MATERIAL / 100
+            << ", Score: " << scoreToString(SCORE) << "\n" << std::endl;
     }
 };
 
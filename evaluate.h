@@ -14,249 +14,553 @@
 #include <limits>
 #include <algorithm>
 #include <stdint.h>
+#include <chrono>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "board.h"
+#include "moves.h"
+#include "movepicker.h"
+#include "pawns.h"
+#include "transposition.h"
+#include "stats.h"
 
-typedef uint64_t Bitboard;
+const int MAX_DEPTH = 64;
+
+// limits for one search, a limit left at zero is not used
+struct SearchLimits {
+    int depth = 0;
+    int64_t moveTime = 0; // milliseconds
+    uint64_t nodes = 0;
+};
+
+// parts of the search that can be turned off to measure what each one is worth, and where to
+// write a line of JSON counters after every search
+struct SearchOptions {
+    bool principalVariation = true; // search moves after the first with a null window
+    bool nullMovePruning = true;
+    bool lateMoveReductions = true;
+    std::ostream* statsLog = nullptr;
+    size_t pawnHashKB = DEFAULT_PAWN_HASH_KB; // for each thread
+    bool chess960 = false; // only changes how moves are written, castles as the king taking its rook
+};
+
+// sent after every finished iteration, and about once a second while a long one runs. a running
+// iteration has finished set to false and only fills in depth, nodes and milliseconds
+struct SearchReport {
+    bool finished = true;
+    int depth = 0;
+    Score score = 0; // from the side to move
+    uint64_t nodes = 0;
+    int64_t milliseconds = 0;
+    std::vector<Move> principalVariation;
+};
 
 class Evaluate {
 private:
-    const float pieceLocationValues[8][8] = {
-            { -.5f, -.4f, -.4f, -.4f, -.4f, -.4f, -.4f, -.5f },
-            { -.4f, -.2f,  .0f,  .0f,  .0f,  .0f, -.2f, -.4f },
-            { -.4f,  .0f,  .1f,  .2f,  .2f,  .1f,  .0f, -.4f },
-            { -.4f,  .0f,  .2f, .25f, .25f,  .2f,  .0f, -.4f },
-            { -.4f,  .0f,  .2f, .25f, .25f,  .2f,  .0f, -.4f },
-            { -.4f,  .0f,  .1f,  .2f,  .2f,  .1f,  .0f, -.4f },
-            { -.4f, -.2f,  .0f,  .0f,  .0f,  .0f, -.2f, -.4f },
-            { -.5f, -.4f, -.4f, -.4f, -.4f, -.4f, -.4f, -.5f }
-        };
-    
-    const float kingLocationValues[8][8] = {
-            { -.3f, -.4f, -.4f, -.5f, -.5f, -.4f, -.4f, -.3f },
-            { -.3f, -.4f, -.4f, -.5f, -.5f, -.4f, -.4f, -.3f },
-            { -.3f, -.4f, -.4f, -.5f, -.5f, -.4f, -.4f, -.3f },
-            { -.3f, -.4f, -.4f, -.5f, -.5f, -.4f, -.4f, -.3f },
-            { -.3f, -.4f, -.4f, -.5f, -.5f, -.4f, -.4f, -.3f },
-            { -.2f, -.2f, -.2f, -.2f, -.2f, -.2f, -.2f, -.2f },
-            {  .2f,  .2f,  .0f,  .0f,  .0f,  .0f,  .2f,  .2f },
-            {  .2f,  .3f,  .1f,  .0f,  .0f,  .1f,  .3f,  .2f }
-        };
-    
-    std::string bestMove;
+    // best move and score of the last completed iteration, and the best move of the one running
+    Move bestMove = NULL_MOVE;
+    Score bestScore = 0; // from white's side
+    Move iterationBestMove = NULL_MOVE;
+    int completedDepth = 0;
+    
+    SearchOptions options;
+    
+    // margin for the positional swing a capture can bring on top of the material it wins
+    static constexpr Score DELTA_MARGIN = 200;
+    
+    // limits are checked every CHECK_INTERVAL + 1 nodes so reading the clock stays cheap
+    static constexpr uint64_t CHECK_INTERVAL = 1023;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0; // quiescence nodes, counted apart from nodes so its share of the tree shows
+    bool stopped = false;
+    SearchStats stats;
+    
+    // set from another thread to end the search, searches running together can share one signal
+    std::atomic<bool> stopRequested = false;
+    std::atomic<bool>* stopSignal = &stopRequested;
+    
+    // nodes copied out when the limits are checked so other threads can read them while searching
+    std::atomic<uint64_t> publishedNodes = 0;
+    
+    std::function<void(const SearchReport&)> reporter;
+    int64_t lastReportTime = 0;
+    int searchingDepth = 0;
+    static constexpr int64_t PROGRESS_INTERVAL = 1000; // milliseconds
+    
+    TranspositionTable& table;
+    PawnTable pawnTable; // one per thread, pawn entries are cheap to redo so it isn't shared
+    
+    // quiet moves that caused cutoffs, two per ply counted from the root, and over the whole search
+    Move killers[MAX_DEPTH + 1][2];
+    HistoryTable history;
+    int rootUndoSize = 0;
+    
+    // moves searched at full depth before late move reductions start
+    static constexpr int LMR_FULL_MOVES = 3;
+    
+    // values are halved once one grows past this so recent cutoffs keep counting
+    static constexpr int HISTORY_LIMIT = 1 << 20;
+    
+    // a quiet move refuted the opponent's last move, so it is tried early in sibling positions
+    void rememberCutoff(const Move MOVE, const int DEPTH, const int PLY, const bool WHITE_MOVED) {
+        if (killers[PLY][0] != MOVE) {
+            killers[PLY][1] = killers[PLY][0];
+            killers[PLY][0] = MOVE;
+        }
+        int& value = history[WHITE_MOVED][moveStart(MOVE)][moveEnd(MOVE)];
+        value += DEPTH * DEPTH;
+        if (value > HISTORY_LIMIT) {
+            for (auto& from : history) {
+                for (auto& to : from) {
+                    for (int& entry : to) {
+                        entry /= 2;
+                    }
+                }
+            }
+        }
+    }
+    
+    int64_t elapsedMilliseconds() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+    }
+    
+    // the first iteration always finishes so there is a move to play
+    void checkLimits() {
+        publishedNodes.store(nodes + qnodes, std::memory_order_relaxed);
+        if (reporter && elapsedMilliseconds() - lastReportTime >= PROGRESS_INTERVAL) {
+            report(false, 0, {});
+        }
+        if (completedDepth > 0 && ((limits.moveTime && elapsedMilliseconds() >= limits.moveTime)
+                || (limits.nodes && nodes + qnodes >= limits.nodes) || stopSignal->load(std::memory_order_relaxed))) {
+            stopped = true;
+        }
+    }
+    
+    void report(const bool FINISHED, const Score SCORE, std::vector<Move> principalVariation) {
+        SearchReport searchReport;
+        searchReport.finished = FINISHED;
+        searchReport.depth = searchingDepth;
+        searchReport.score = SCORE;
+        searchReport.nodes = nodes + qnodes;
+        searchReport.milliseconds = elapsedMilliseconds();
+        searchReport.principalVariation = std::move(principalVariation);
+        lastReportTime = searchReport.milliseconds;
+        reporter(searchReport);
+    }
     
 public:
-    float minimax(const int DEPTH, float alpha, float beta, const bool WHITE_TURN, 
-        const bool FIRST_TIME, Moves moves1, Bitboard& enPassant, 
-        Bitboard& whitePawns, Bitboard& whiteKnights, Bitboard& whiteBishops, 
-        Bitboard& whiteRooks, Bitboard& whiteQueens, Bitboard& whiteKing,
-        Bitboard& blackPawns, Bitboard& blackKnights, Bitboard& blackBishops, 
-        Bitboard& blackRooks, Bitboard& blackQueens, Bitboard& blackKing) {
+    Evaluate(TranspositionTable& table) : table(table) {}
+    
+    // use a stop signal owned by someone else, whoever owns it clears it before searching
+    void shareStopSignal(std::atomic<bool>& signal) {
+        stopSignal = &signal;
+    }
+    
+    void setOptions(const SearchOptions& OPTIONS) {
+        if (OPTIONS.pawnHashKB != options.pawnHashKB) {
+            pawnTable.resize(OPTIONS.pawnHashKB);
+        }
+        options = OPTIONS;
+    }
+    
+    // called on the searching thread, an empty function turns reports off
+    void setReporter(const std::function<void(const SearchReport&)>& REPORTER) {
+        reporter = REPORTER;
+    }
+    
+    // safe to call from any thread, the search ends within CHECK_INTERVAL nodes
+    void stop() {
+        stopSignal->store(true, std::memory_order_relaxed);
+    }
+    
+    // iterative deepening, search depth FIRST_DEPTH, FIRST_DEPTH + 1... until a limit is hit and return
+    // the best move of the last iteration that finished, a stopped iteration is thrown away
+    Move search(const SearchLimits& LIMITS, Moves& moves1, Position& position, const int FIRST_DEPTH = 1) {
+        limits = LIMITS;
+        startTime = std::chrono::steady_clock::now();
+        nodes = 0;
+        qnodes = 0;
+        pawnTable.resetCounters();
+        stats = SearchStats();
+#ifdef SEARCH_PROFILE
+        PHASE_TIMES = PhaseTimes();
+#endif
+        publishedNodes.store(0, std::memory_order_relaxed);
+        lastReportTime = 0;
+        
+        // a stop meant for the last search mustn't end this one. a shared signal belongs to whoever
+        // shares it, so only the object's own is cleared
+        stopRequested.store(false, std::memory_order_relaxed);
+        stopped = false;
+        completedDepth = 0;
+        bestMove = NULL_MOVE;
+        bestScore = 0;
+        rootUndoSize = position.undoSize;
+        std::fill(&killers[0][0], &killers[0][0] + (MAX_DEPTH + 1) * 2, NULL_MOVE);
+        std::fill(&history[0][0][0], &history[0][0][0] + 2 * 64 * 64, 0);
         
-        if (DEPTH == 0 || gameOver(WHITE_TURN, moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing)) {
-            return evaluate(WHITE_TURN, DEPTH, moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
+        const int MAX_ITERATION = LIMITS.depth > 0 ? std::min(LIMITS.depth, MAX_DEPTH) : MAX_DEPTH;
+        stats.firstDepth = std::min(FIRST_DEPTH, MAX_ITERATION);
+        uint64_t previousNodes = 0;
+        for (int depth = stats.firstDepth; depth <= MAX_ITERATION; ++depth) {
+            iterationBestMove = NULL_MOVE;
+            searchingDepth = depth;
+            const Score SCORE = negamax(depth, -INFINITE_SCORE, INFINITE_SCORE, true, moves1, position);
+            if (stopped) {
+                break;
+            }
+            bestMove = iterationBestMove;
+            bestScore = position.whiteTurn ? SCORE : -SCORE;
+            completedDepth = depth;
+            stats.iterationNodes.push_back(nodes + qnodes - previousNodes);
+            previousNodes = nodes + qnodes;
+            publishedNodes.store(nodes + qnodes, std::memory_order_relaxed);
+            if (reporter) {
+                report(true, SCORE, principalVariation(moves1, position));
+            }
+            
+            // the next iteration takes longer than all before it, don't start one that can't finish
+            if (LIMITS.moveTime && elapsedMilliseconds() * 2 >= LIMITS.moveTime) {
+                break;
+            }
         }
         
-        if (WHITE_TURN) {
-            const std::string MOVES = moves1.possibleMovesWhite(enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-            float maxScore = std::numeric_limits<float>::lowest();
-            for (int i = 0; i < MOVES.length(); i += 5) {
-                const std::string MOVE = MOVES.substr(i, 5);
-                moves1.doMove(MOVE, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                
-                const bool WHITE_CHECKED = whiteKing & moves1.otherThreats(false, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                if (WHITE_CHECKED) {
-                    moves1.undoMove(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                    continue;
+        stats.nodes = nodes + qnodes;
+        stats.qnodes = qnodes;
+#ifdef SEARCH_PROFILE
+        stats.phases = PHASE_TIMES;
+#endif
+        return bestMove;
+    }
+    
+    // principal variation search, scores are from the side to move. the first move gets the full
+    // window and the rest a null window that only proves them worse, a move that isn't is searched again
+    Score negamax(const int DEPTH, Score alpha, const Score beta, const bool NULL_ALLOWED,
+        Moves& moves1, Position& position) {
+        
+        if ((++nodes & CHECK_INTERVAL) == 0) {
+            checkLimits();
+        }
+        if (stopped) {
+            return 0;
+        }
+        
+        const int PLY = std::min(position.undoSize - rootUndoSize, MAX_DEPTH);
+        const bool ROOT = PLY == 0;
+        const bool PV_NODE = beta - alpha > 1;
+        
+        // draws come before the table since a stored score may have been reached another way
+        if (!ROOT && isDraw(rootUndoSize, moves1, position)) {
+            return 0;
+        }
+        
+        // a stored search at least as deep can answer outright, except on the principal variation
+        // where the exact line matters
+        TTData entry;
+        const bool FOUND = table.probe(position.key, entry);
+        const Move HASH_MOVE = FOUND ? entry.move : NULL_MOVE;
+        ++stats.ttProbes;
+        stats.ttHits += FOUND;
+        if (FOUND && !PV_NODE && entry.depth >= DEPTH) {
+            const Score STORED = scoreFromTable(entry.score, PLY);
+            if (entry.bound == EXACT_BOUND || (entry.bound == LOWER_BOUND && STORED >= beta)
+                    || (entry.bound == UPPER_BOUND && STORED <= alpha)) {
+                ++stats.ttCutoffs;
+                return STORED;
+            }
+        }
+        
+        if (DEPTH <= 0) {
+            return quiesce(alpha, beta, moves1, position);
+        }
+        
+        const Score SIGN = position.whiteTurn ? 1 : -1;
+        const bool IN_CHECK = moves1.inCheck(position);
+        
+        // null move pruning, if passing still leaves the opponent below beta a real move will too. in
+        // check passing is illegal, and with only pawns left passing can be the best move (zugzwang)
+        if (options.nullMovePruning && NULL_ALLOWED && !PV_NODE && !IN_CHECK && DEPTH >= 3 && hasPieces(position)
+                && SIGN * staticScore(position) >= beta) {
+            const int REDUCTION = DEPTH >= 7 ? 3 : 2;
+            moves1.doNullMove(position);
+            const Score SCORE = -negamax(DEPTH - 1 - REDUCTION, -beta, -beta + 1, false, moves1, position);
+            moves1.undoNullMove(position);
+            if (stopped) {
+                return 0;
+            }
+            if (SCORE >= beta) {
+                return beta;
+            }
+        }
+        
+        const Score ALPHA = alpha;
+        Move nodeBestMove = NULL_MOVE;
+        Score bestScore = -INFINITE_SCORE;
+        
+        // moves come out hash move first, then captures that don't lose material, killers, quiets by
+        // history and last the losing captures. no legal moves is the end of the game, so mates are
+        // found here without a separate check
+        MovePicker picker(moves1, position, HASH_MOVE, killers[PLY], history);
+        int movesSearched = 0;
+        for (Move move = picker.next(); move != NULL_MOVE; move = picker.next()) {
+            const bool QUIET = MovePicker::isQuiet(move, position);
+            moves1.doMove(move, position);
+            
+            Score score;
+            if (movesSearched == 0) {
+                score = -negamax(DEPTH - 1, -beta, -alpha, true, moves1, position);
+            } else {
+                // late quiet moves are unlikely to be best after ordering, so they get a shallower
+                // look first and the full depth only if they beat alpha
+                int reduction = 0;
+                if (options.lateMoveReductions && DEPTH >= 3 && movesSearched >= LMR_FULL_MOVES && QUIET
+                        && !IN_CHECK && !moves1.inCheck(position)) {
+                    reduction = DEPTH >= 6 && movesSearched >= 2 * LMR_FULL_MOVES ? 2 : 1;
                 }
                 
-                const float SCORE = minimax(DEPTH - 1, alpha, beta, !WHITE_TURN, false, moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                moves1.undoMove(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                
-                if (FIRST_TIME && SCORE > maxScore) {
-                    bestMove = MOVE;
+                const Score WINDOW_BETA = options.principalVariation ? alpha + 1 : beta;
+                score = -negamax(DEPTH - 1 - reduction, -WINDOW_BETA, -alpha, true, moves1, position);
+                if (score > alpha && reduction) {
+                    score = -negamax(DEPTH - 1, -WINDOW_BETA, -alpha, true, moves1, position);
                 }
-                maxScore = std::max(SCORE, maxScore);
-                alpha = std::max(alpha, maxScore);
-                if (beta <= alpha) {
-                    return maxScore;
+                if (score > alpha && score < beta && options.principalVariation) {
+                    score = -negamax(DEPTH - 1, -beta, -alpha, true, moves1, position);
                 }
             }
-            return maxScore;
-        } else {
-            const std::string MOVES = moves1.possibleMovesBlack(enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-            float minScore = std::numeric_limits<float>::max();
-            for (int i = 0; i < MOVES.length(); i += 5) {
-                const std::string MOVE = MOVES.substr(i, 5);
-                moves1.doMove(MOVE, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                
-                const bool BLACK_CHECKED = blackKing & moves1.otherThreats(true, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                if (BLACK_CHECKED) {
-                    moves1.undoMove(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                    continue;
-                }
-                
-                const float SCORE = minimax(DEPTH - 1, alpha, beta, !WHITE_TURN, false, moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                moves1.undoMove(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-                
-                if (FIRST_TIME && SCORE < minScore) {
-                    bestMove = MOVE;
+            moves1.undoMove(move, position);
+            if (stopped) {
+                return 0;
+            }
+            ++movesSearched;
+            
+            if (score > bestScore) {
+                bestScore = score;
+                nodeBestMove = move;
+                if (ROOT) {
+                    iterationBestMove = move;
                 }
-                minScore = std::min(SCORE, minScore);
-                beta = std::min(beta, minScore);
-                if (beta <= alpha) {
-                    return minScore;
+            }
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                ++stats.betaCutoffs;
+                stats.firstMoveCutoffs += movesSearched == 1;
+                if (QUIET) {
+                    rememberCutoff(move, DEPTH, PLY, position.whiteTurn);
                 }
+                break;
             }
-            return minScore;
         }
+        if (movesSearched == 0) {
+            return noMovesScore(PLY, moves1, position);
+        }
+        
+        const Bound BOUND = bestScore <= ALPHA ? UPPER_BOUND : bestScore >= beta ? LOWER_BOUND : EXACT_BOUND;
+        table.store(position.key, nodeBestMove, DEPTH, scoreToTable(bestScore, PLY), BOUND);
+        return bestScore;
     }
     
-    std::string getBestMove() {
+    Move getBestMove() {
         return bestMove;
     }
     
-    float evaluate(const bool WHITE_TURN, const int DEPTH, Moves moves1, Bitboard enPassant,
-            Bitboard whitePawns, Bitboard whiteKnights, Bitboard whiteBishops, 
-            Bitboard whiteRooks, Bitboard whiteQueens, Bitboard whiteKing,
-            Bitboard blackPawns, Bitboard blackKnights, Bitboard blackBishops, 
-            Bitboard blackRooks, Bitboard blackQueens, Bitboard blackKing) {
-        
-        const bool BLACK_CHECKED = !WHITE_TURN && blackKing & moves1.otherThreats(true, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        const bool BLACK_MATED = BLACK_CHECKED && noBlackMoves(moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        if (BLACK_MATED) {
-            return 1000 + DEPTH; // add depth to prioritize faster mates
-        }
-        
-        const bool WHITE_CHECKED = WHITE_TURN && whiteKing & moves1.otherThreats(false, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        const bool WHITE_MATED = WHITE_CHECKED && noWhiteMoves(moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        if (WHITE_MATED) {
-            return -1000 - DEPTH; // subtract depth to prioritize faster mates
-        }
-        
-        const bool STALEMATE = (WHITE_TURN && noWhiteMoves(moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing))
-            || (!WHITE_TURN && noBlackMoves(moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing))
-            || notEnoughPieces(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens);
-        if (STALEMATE) {
-            return 0;
-        }
-        
-        return materialScore(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens)
-            + positionScore(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
+    Score getBestScore() {
+        return bestScore;
     }
     
-    bool gameOver(const bool WHITE_TURN, Moves moves1, Bitboard enPassant,
-        Bitboard whitePawns, Bitboard whiteKnights, Bitboard whiteBishops, 
-        Bitboard whiteRooks, Bitboard whiteQueens, Bitboard whiteKing,
-        Bitboard blackPawns, Bitboard blackKnights, Bitboard blackBishops, 
-        Bitboard blackRooks, Bitboard blackQueens, Bitboard blackKing) {
-        
-        return (WHITE_TURN && noWhiteMoves(moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing))
-            || (!WHITE_TURN && noBlackMoves(moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing))
-            || notEnoughPieces(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens);
+    int getCompletedDepth() {
+        return completedDepth;
     }
     
-    bool noWhiteMoves(Moves moves1, Bitboard& enPassant,
-            Bitboard& whitePawns, Bitboard& whiteKnights, Bitboard& whiteBishops, 
-            Bitboard& whiteRooks, Bitboard& whiteQueens, Bitboard& whiteKing,
-            Bitboard& blackPawns, Bitboard& blackKnights, Bitboard& blackBishops, 
-            Bitboard& blackRooks, Bitboard& blackQueens, Bitboard& blackKing) {
-        
-        const std::string MOVES = moves1.possibleMovesWhite(enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        for (int i = 0; i < MOVES.length(); i += 5) {
-            moves1.doMove(MOVES.substr(i, 5), enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-            const bool WHITE_CHECKED = whiteKing & moves1.otherThreats(false, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-            if (!WHITE_CHECKED) {
-                return false;
-            }
-            moves1.undoMove(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        } return true;
+    uint64_t getNodes() {
+        return nodes;
     }
     
-    bool noBlackMoves(Moves moves1, Bitboard& enPassant,
-            Bitboard& whitePawns, Bitboard& whiteKnights, Bitboard& whiteBishops, 
-            Bitboard& whiteRooks, Bitboard& whiteQueens, Bitboard& whiteKing,
-            Bitboard& blackPawns, Bitboard& blackKnights, Bitboard& blackBishops, 
-            Bitboard& blackRooks, Bitboard& blackQueens, Bitboard& blackKing) {
-        
-        const std::string MOVES = moves1.possibleMovesBlack(enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        for (int i = 0; i < MOVES.length(); i += 5) {
-            moves1.doMove(MOVES.substr(i, 5), enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-            const bool BLACK_CHECKED = blackKing & moves1.otherThreats(true, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-            if (!BLACK_CHECKED) {
-                return false;
+    uint64_t getQNodes() {
+        return qnodes;
+    }
+    
+    // nodes and quiescence nodes as of the last limit check, safe to read from any thread. search
+    // clears them as it starts, clearPublishedNodes does it sooner for a thread that starts late
+    uint64_t getPublishedNodes() const {
+        return publishedNodes.load(std::memory_order_relaxed);
+    }
+    
+    void clearPublishedNodes() {
+        publishedNodes.store(0, std::memory_order_relaxed);
+    }
+    
+    // the best move followed by the moves stored for the positions after it, no longer than the
+    // search was deep and cut short at a position that repeats since the line would never end
+    std::vector<Move> principalVariation(Moves& moves1, Position& position) {
+        std::vector<Move> line;
+        TTData entry;
+        Move move = bestMove;
+        while (move != NULL_MOVE && static_cast<int>(line.size()) < completedDepth && moves1.isLegal(move, position)) {
+            line.push_back(move);
+            moves1.doMove(move, position);
+            if (position.isRepetition(rootUndoSize)) {
+                break;
             }
-            moves1.undoMove(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        } return true;
+            move = table.probe(position.key, entry) ? entry.move : NULL_MOVE;
+        }
+        for (auto it = line.rbegin(); it != line.rend(); ++it) {
+            moves1.undoMove(*it, position);
+        }
+        return line;
     }
     
-    constexpr bool notEnoughPieces(
-        const Bitboard whitePawns, const Bitboard whiteKnights, const Bitboard whiteBishops, 
-        const Bitboard whiteRooks, const Bitboard whiteQueens,
-        const Bitboard blackPawns, const Bitboard blackKnights, const Bitboard blackBishops, 
-        const Bitboard blackRooks, const Bitboard blackQueens) {
-        
-        return __builtin_popcountll(whitePawns | whiteKnights | whiteBishops | whiteRooks | whiteQueens
-            | blackPawns | blackKnights | blackBishops | blackRooks | blackQueens) == 0;
+    // counters of the last search, nodes include quiescence nodes like getPublishedNodes
+    const SearchStats& getStats() {
+        return stats;
     }
     
-    constexpr int materialScore(
-        const Bitboard whitePawns, const Bitboard whiteKnights, const Bitboard whiteBishops, 
-        const Bitboard whiteRooks, const Bitboard whiteQueens,
-        const Bitboard blackPawns, const Bitboard blackKnights, const Bitboard blackBishops, 
-        const Bitboard blackRooks, const Bitboard blackQueens) {
-        
-        return __builtin_popcountll(whitePawns)
-            + 3 * __builtin_popcountll(whiteKnights | whiteBishops)
-            + 5 * __builtin_popcountll(whiteRooks)
-            + 9 * __builtin_popcountll(whiteQueens)
-            - __builtin_popcountll(blackPawns)
-            - 3 * __builtin_popcountll(blackKnights | blackBishops)
-            - 5 * __builtin_popcountll(blackRooks)
-            - 9 * __builtin_popcountll(blackQueens);
-    }
-    
-    float positionScore(
-        const Bitboard whitePawns, const Bitboard whiteKnights, const Bitboard whiteBishops, 
-        const Bitboard whiteRooks, const Bitboard whiteQueens, const Bitboard whiteKing,
-        const Bitboard blackPawns, const Bitboard blackKnights, const Bitboard blackBishops, 
-        const Bitboard blackRooks, const Bitboard blackQueens, const Bitboard blackKing) {
-        
-        float score = 0;
+    const PawnTable& getPawnTable() {
+        return pawnTable;
+    }
+    
+    // search only captures and promotions past the horizon so a position isn't scored in the middle
+    // of an exchange. scores are from the side to move, standing pat on the static score is allowed
+    // unless in check, then every evasion is searched
+    Score quiesce(Score alpha, const Score beta, Moves& moves1, Position& position) {
+        if ((++qnodes & CHECK_INTERVAL) == 0) {
+            checkLimits();
+        }
+        if (stopped || notEnoughPieces(position)) {
+            return 0;
+        }
         
-        // location value for white pieces (excluding king)
-        Bitboard pieces = whitePawns | whiteKnights | whiteBishops | whiteRooks | whiteQueens;
-        Bitboard smallestPiece;
-        int pieceLocation;
-        while(pieces) {
-            smallestPiece = pieces & -pieces;
-            pieces ^= smallestPiece;
-            pieceLocation = __builtin_clzll(smallestPiece);
-            score += pieceLocationValues[pieceLocation / 8][pieceLocation % 8];
+        const Score SIGN = position.whiteTurn ? 1 : -1;
+        if (position.undoSize - rootUndoSize >= MAX_SEARCH_PLIES) {
+            return SIGN * staticScore(position);
+        }
+        const bool IN_CHECK = moves1.inCheck(position);
+        Score standPat = -INFINITE_SCORE;
+        if (!IN_CHECK) {
+            standPat = SIGN * staticScore(position);
+            if (standPat >= beta) {
+                return standPat;
+            }
+            alpha = std::max(alpha, standPat);
         }
         
-        // location value for black pieces (excluding king)
-        pieces = blackPawns | blackKnights | blackBishops | blackRooks | blackQueens;
-        while(pieces) {
-            smallestPiece = pieces & -pieces;
-            pieces ^= smallestPiece;
-            pieceLocation = __builtin_clzll(smallestPiece);
-            score -= pieceLocationValues[pieceLocation / 8][pieceLocation % 8];
+        // out of check the picker leaves out captures that lose material in the exchange
+        MovePicker picker(moves1, position, IN_CHECK);
+        Score bestScore = standPat;
+        int movesSearched = 0;
+        for (Move move = picker.next(); move != NULL_MOVE; move = picker.next()) {
+            if (!IN_CHECK) {
+                // under promotions almost never beat a queen
+                if (isPromotion(move) && moveFlag(move) != PROMOTE_Q) {
+                    continue;
+                }
+                
+                // delta pruning, skip captures that can't reach alpha even winning the piece for free
+                if (!isPromotion(move) && standPat + capturedValue(move, position) + DELTA_MARGIN < alpha) {
+                    continue;
+                }
+            }
+            
+            moves1.doMove(move, position);
+            const Score SCORE = -quiesce(-beta, -alpha, moves1, position);
+            moves1.undoMove(move, position);
+            if (stopped) {
+                return 0;
+            }
+            ++movesSearched;
+            
+            bestScore = std::max(bestScore, SCORE);
+            alpha = std::max(alpha, SCORE);
+            if (alpha >= beta) {
+                break;
+            }
         }
         
-        // location value for white king
-        if (whiteKing) {
-            pieceLocation = __builtin_clzll(whiteKing);
-            score += kingLocationValues[pieceLocation / 8][pieceLocation % 8];
+        // every evasion is searched when in check, so none means checkmate
+        if (IN_CHECK && movesSearched == 0) {
+            return noMovesScore(position.undoSize - rootUndoSize, moves1, position);
+        }
+        return bestScore;
+    }
+    
+    // material the move captures
+    int capturedValue(const Move MOVE, const Position& position) {
+        const int VICTIM = capturedPiece(MOVE, position);
+        return VICTIM == NO_PIECE ? 0 : std::abs(PIECE_VALUES[VICTIM]);
+    }
+    
+    // score from white's side without searching, mate and stalemate are still found. the legal
+    // move query stops at the first move it finds
+    Score evaluate(Moves& moves1, Position& position) {
+        if (isDraw(position.undoSize, moves1, position)) {
+            return 0;
+        }
+        if (!moves1.hasLegalMove(position)) {
+            return position.whiteTurn ? noMovesScore(0, moves1, position) : -noMovesScore(0, moves1, position);
         }
         
-        // location value for black king
-        if (blackKing) {
-            pieceLocation = __builtin_clzll(blackKing);
-            score -= kingLocationValues[7 - pieceLocation / 8][pieceLocation % 8];
+        return staticScore(position);
+    }
+    
+    // score for the side to move when it has no legal moves, checkmate or stalemate. PLY is how far
+    // the position is from the root so nearer mates score higher
+    Score noMovesScore(const int PLY, Moves& moves1, const Position& position) {
+        return moves1.inCheck(position) ? -MATE_SCORE + PLY : 0;
+    }
+    
+    bool gameOver(Moves& moves1, Position& position) {
+        return !moves1.hasLegalMove(position) || isDraw(position.undoSize, moves1, position);
+    }
+    
+    // draw by repetition, the fifty move rule or material, mate and stalemate aren't checked. positions
+    // from SEARCH_ROOT on only need to repeat once, see Position::isRepetition
+    bool isDraw(const int SEARCH_ROOT, Moves& moves1, const Position& position) {
+        if (notEnoughPieces(position) || position.isRepetition(SEARCH_ROOT)) {
+            return true;
         }
         
-        return score;
+        // a mate on the hundredth ply still wins
+        return position.halfmoveClock >= 100 && (!moves1.inCheck(position) || moves1.hasLegalMove(position));
+    }
+    
+    // neither side can mate, only the kings are left or one side has a single knight or bishop
+    bool notEnoughPieces(const Position& position) {
+        const Bitboard OTHERS = position.occupied() ^ position.pieces[WHITE_KING] ^ position.pieces[BLACK_KING];
+        return (OTHERS & (OTHERS - 1)) == 0 && (OTHERS & (position.pieces[WHITE_PAWN] | position.pieces[BLACK_PAWN]
+            | position.pieces[WHITE_ROOK] | position.pieces[BLACK_ROOK] | position.pieces[WHITE_QUEEN] | position.pieces[BLACK_QUEEN])) == 0;
+    }
+    
+    // whether the side to move has anything besides pawns and its king
+    bool hasPieces(const Position& position) {
+        return position.whiteTurn
+            ? (position.whitePieces ^ position.pieces[WHITE_PAWN] ^ position.pieces[WHITE_KING]) != 0
+            : (position.blackPieces ^ position.pieces[BLACK_PAWN] ^ position.pieces[BLACK_KING]) != 0;
     }
     
+    // material and placement are kept up to date by the position as moves are made
+    Score materialScore(const Position& position) {
+        return position.material;
+    }
+    
+    // the middlegame and endgame placements blended by how many pieces are left, promotions can
+    // push the phase past MAX_PHASE
+    Score positionScore(const Position& position) {
+        const int PHASE = std::min(position.phase, MAX_PHASE);
+        return (position.middlegamePlacement * PHASE + position.endgamePlacement * (MAX_PHASE - PHASE)) / MAX_PHASE;
+    }
+    
+    Score pawnScore(const Position& position) {
+        return pawnTable.score(position);
+    }
+    
+    // score of the position without searching from white's side
+    Score staticScore(const Position& position) {
+        PROFILE_PHASE(EVALUATION);
+        return materialScore(position) + positionScore(position) + pawnScore(position);
+    }
+
 };
 
 #endif
\ No newline at end of file
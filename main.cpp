@@ -12,22 +12,33 @@
 #include "board.h"
 #include "moves.h"
 #include "evaluate.h"
+#include "perft.h"
+#include "smp.h"
+#include "uci.h"
+#include "batch.h"
+#include "bench.h"
+#include "book.h"
 #include <limits>
 #include <stdint.h>
 
 typedef uint64_t Bitboard;
 
-enum GameType {CHESS, CHESS960};
+enum GameType {CHESS, CHESS960, UCI};
 enum OpponentType {PLAYER, ENGINE};
 enum PlayerColor {WHITE, BLACK};
 
+// a GUI starting the engine without arguments answers with uci
 GameType getGameType() {
+    std::string answer;
     char gameType;
 
     do {
         std::cout << "Play [c]hess or c[h]ess960? ";
-        std::cin >> gameType;
-        gameType = toupper(gameType);
+        std::cin >> answer;
+        if (answer == "uci") {
+            return UCI;
+        }
+        gameType = toupper(answer[0]);
     } while ((gameType != 'C') && (gameType != 'H'));
 
     return gameType == 'C' ? CHESS : CHESS960;
@@ -57,108 +68,293 @@ PlayerColor getPlayerColor() {
     return playerColor == 'W' ? WHITE : BLACK;
 }
 
-int getEngineDepth() {
-    int depth;
+int getEngineTime() {
+    int milliseconds;
 
     do {
-        std::cout << "What engine depth (int 1-5)? ";
-        std::cin >> depth;
-        depth = toupper(depth);
-    } while ((depth < 1) || (depth > 5));
+        std::cout << "How many milliseconds can the engine think per move (int 10-600000)? ";
+        std::cin >> milliseconds;
+    } while ((milliseconds < 10) || (milliseconds > 600000));
+
+    return milliseconds;
+}
 
-    return depth;
+// convert a move to the xyxy coordinates printed around the board, castles show where the king lands
+std::string moveToString(const Move MOVE) {
+    const int START = moveStart(MOVE);
+    const int END = moveFlag(MOVE) == CASTLE ? castleKingEnd(MOVE) : moveEnd(MOVE);
+    return std::to_string(START % 8) + std::to_string(7 - START / 8)
+        + std::to_string(END % 8) + std::to_string(7 - END / 8);
 }
 
-std::string getPlayerMove(const bool WHITE_TURN, Moves moves1) {
+Move getPlayerMove(Moves& moves1, Position& position) {
+    const bool WHITE_TURN = position.whiteTurn;
     std::string move;
-    const std::string MOVES = WHITE_TURN ?
-        moves1.possibleMovesWhite(enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing)
-        : moves1.possibleMovesBlack(enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
+    MoveList moveList;
+    if (WHITE_TURN) {
+        moves1.possibleMovesWhite(moveList, position);
+    } else {
+        moves1.possibleMovesBlack(moveList, position);
+    }
     
-    bool illegalCheck;
+    // collect every legal move matching the typed coordinates
+    MoveList matches;
     do {
         std::cout << "Choose your move (xyxy) ";
         std::cin >> move;
-        moves1.doMove(" " + move, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        illegalCheck = (WHITE_TURN && whiteKing & moves1.otherThreats(false, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing))
-                                || (!WHITE_TURN && blackKing & moves1.otherThreats(true, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing));
-        moves1.undoMove(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-    } while (move.length() != 4 || MOVES.find(move) == std::string::npos || illegalCheck);
+        matches.size = 0;
+        for (const Move MOVE : moveList) {
+            if (moveToString(MOVE) == move) {
+                matches.add(MOVE);
+            }
+        }
+    } while (matches.size == 0);
     
     // if pawn is promoting ask what user would like to promote to or castle
-    char specialMoveType = ' ';
-    if (MOVES.find('Q' + move) != std::string::npos) {
+    if (isPromotion(matches[0])) {
+        char promotionType;
         do {
             std::cout << "Promote to what (N/B/R/Q)? ";
-            std::cin >> specialMoveType;
-        } while ((specialMoveType != 'N') && (specialMoveType != 'B') && (specialMoveType != 'R') && (specialMoveType != 'Q'));
-    } else if (MOVES.find('C' + move) != std::string::npos) {
-        specialMoveType = 'C';
+            std::cin >> promotionType;
+        } while ((promotionType != 'N') && (promotionType != 'B') && (promotionType != 'R') && (promotionType != 'Q'));
+        const int FLAG = promotionType == 'N' ? PROMOTE_N : promotionType == 'B' ? PROMOTE_B
+                        : promotionType == 'R' ? PROMOTE_R : PROMOTE_Q;
+        return makeMove(moveStart(matches[0]), moveEnd(matches[0]), FLAG);
+    } else if (matches.size > 1) {
         // if castle and not castle both possible with same king move, ask which
-        if (MOVES.find(' ' + move) != std::string::npos) {
-            char castle;
-            do {
-                std::cout << "Castle (y/n)? ";
-                std::cin >> castle;
-            } while (castle != 'y' && castle != 'n');
-            specialMoveType = castle == 'y' ? 'C' : ' ';
+        char castle;
+        do {
+            std::cout << "Castle (y/n)? ";
+            std::cin >> castle;
+        } while (castle != 'y' && castle != 'n');
+        for (const Move MOVE : matches) {
+            if ((moveFlag(MOVE) == CASTLE) == (castle == 'y')) {
+                return MOVE;
+            }
         }
     }
     
-    return specialMoveType + move;
+    return matches[0];
+}
+
+// join command line arguments from FIRST on into a FEN, or the start position if there are none
+std::string argumentsToFen(const size_t FIRST, const std::vector<std::string>& ARGUMENTS) {
+    std::string fen;
+    for (size_t i = FIRST; i < ARGUMENTS.size(); ++i) {
+        fen += ARGUMENTS[i] + " ";
+    }
+    return fen.empty() ? START_FEN : fen;
 }
 
-int main() {
+// non interactive modes, uci, perft <depth> [fen], divide <depth> [fen], perftsuite [depth],
+// bench [depth] [threads] [hash], smpbench [depth] [threads], epd <file> [depth] [threads], fen [fen],
+// attackbench, psqt and pawnsuite
+int runCommand(const std::vector<std::string>& ARGUMENTS, TranspositionTable& table, const int THREADS,
+    const SearchOptions& OPTIONS, PolyglotBook& book) {
+    const std::string COMMAND = ARGUMENTS[0];
+    Moves moves1;
+    Perft perft1;
+    
+    if (COMMAND == "uci") {
+        Uci uci1(table, THREADS, OPTIONS, book);
+        uci1.loop();
+        return 0;
+    } else if (COMMAND == "epd" && ARGUMENTS.size() > 1) {
+        std::ifstream file(ARGUMENTS[1]);
+        if (!file) {
+            std::cout << "Could not open " << ARGUMENTS[1] << std::endl;
+            return 1;
+        }
+        SearchLimits limits;
+        limits.depth = ARGUMENTS.size() > 2 ? std::stoi(ARGUMENTS[2]) : 8;
+        BatchAnalysis batch1(ARGUMENTS.size() > 3 ? std::stoi(ARGUMENTS[3]) : THREADS, table.sizeMB(), OPTIONS);
+        batch1.run(file, std::cout, limits);
+        return 0;
+    } else if (COMMAND == "fen") {
+        std::cout << Board::positionToFen(Board::fenToPosition(argumentsToFen(1, ARGUMENTS))) << std::endl;
+        return 0;
+    } else if (COMMAND == "attackbench") {
+        SLIDER_ATTACKS.benchmark(100000000);
+        return 0;
+    } else if (COMMAND == "pawnsuite") {
+        return PawnTable::runSuite() ? 0 : 1;
+    } else if (COMMAND == "psqt") {
+        writePieceSquareTables(std::cout);
+        return 0;
+    } else if (COMMAND == "bench") {
+        Bench::run(ARGUMENTS.size() > 1 ? std::stoi(ARGUMENTS[1]) : 10, ARGUMENTS.size() > 2 ? std::stoi(ARGUMENTS[2]) : THREADS,
+            ARGUMENTS.size() > 3 ? std::stoul(ARGUMENTS[3]) : table.sizeMB(), OPTIONS, book);
+        return 0;
+    } else if (COMMAND == "smpbench") {
+        ParallelSearch search1(table, 1);
+        search1.setOptions(OPTIONS);
+        search1.benchmark(ARGUMENTS.size() > 1 ? std::stoi(ARGUMENTS[1]) : 7,
+            ARGUMENTS.size() > 2 ? std::stoi(ARGUMENTS[2]) : THREADS);
+        return 0;
+    } else if (COMMAND == "perftsuite") {
+        return perft1.runSuite(ARGUMENTS.size() > 1 ? std::stoi(ARGUMENTS[1]) : 4, moves1) ? 0 : 1;
+    } else if ((COMMAND == "perft" || COMMAND == "divide") && ARGUMENTS.size() > 1) {
+        const int DEPTH = std::stoi(ARGUMENTS[1]);
+        Position position = Board::fenToPosition(argumentsToFen(2, ARGUMENTS));
+        const auto START = std::chrono::steady_clock::now();
+        uint64_t nodes = 0;
+        
+        if (COMMAND == "divide") {
+            const bool CHESS960 = Board::isChess960(position);
+            for (const auto& [MOVE, COUNT] : perft1.divide(DEPTH, moves1, position)) {
+                std::cout << moveToAlgebraic(MOVE, CHESS960) << ": " << COUNT << "\n";
+                nodes += COUNT;
+            }
+        } else {
+            nodes = perft1.perft(DEPTH, moves1, position);
+        }
+        
+        const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+        std::cout << "Nodes: " << nodes << ", Time: " << SECONDS << "s, NPS: "
+            << static_cast<uint64_t>(nodes / std::max(SECONDS, 1e-9)) << std::endl;
+        return 0;
+    }
+    
+    std::cout << "Usage: [--hash <MB>] [--threads <n>] [--psqt <file>] [--pawn-hash <KB>] [--stats <file>] [--book <file>] [--no-pvs] [--no-null-move] [--no-lmr] uci | perft <depth> [fen] | divide <depth> [fen] | perftsuite [depth]"
+        << " | bench [depth] [threads] [hash] | smpbench [depth] [threads] | epd <file> [depth] [threads] | fen [fen] | attackbench | psqt | pawnsuite" << std::endl;
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    // options come before any command, --hash <MB> sets the transposition table size
+    // and --threads <n> how many threads search. --pawn-hash <KB> sizes each thread's pawn table. --psqt <file> loads piece square tables written
+    // like the psqt command prints them. --no-pvs, --no-null-move and --no-lmr turn off parts
+    // of the search to measure them, and --stats <file> appends a line of JSON counters per search.
+    // --book <file> plays moves from a Polyglot opening book while it has them
+    size_t hashMB = 16;
+    int threads = 1;
+    SearchOptions options;
+    std::ofstream statsLog;
+    PolyglotBook book;
+    int firstArgument = 1;
+    
+    // numbers are read with stoi and stoul, which throw on anything that isn't one
+    try {
+        while (firstArgument < argc) {
+            const std::string OPTION = argv[firstArgument];
+            if (OPTION == "--no-pvs") {
+                options.principalVariation = false;
+            } else if (OPTION == "--no-null-move") {
+                options.nullMovePruning = false;
+            } else if (OPTION == "--no-lmr") {
+                options.lateMoveReductions = false;
+            } else if (OPTION == "--hash" && firstArgument + 1 < argc) {
+                hashMB = std::stoul(argv[++firstArgument]);
+            } else if (OPTION == "--pawn-hash" && firstArgument + 1 < argc) {
+                options.pawnHashKB = std::max<size_t>(1, std::stoul(argv[++firstArgument]));
+            } else if (OPTION == "--threads" && firstArgument + 1 < argc) {
+                threads = std::max(1, std::stoi(argv[++firstArgument]));
+            } else if (OPTION == "--stats" && firstArgument + 1 < argc) {
+                statsLog.open(argv[++firstArgument], std::ios::app);
+                if (!statsLog) {
+                    std::cout << "Could not open " << argv[firstArgument] << std::endl;
+                    return 1;
+                }
+                options.statsLog = &statsLog;
+            } else if (OPTION == "--book" && firstArgument + 1 < argc) {
+                if (!book.open(argv[++firstArgument])) {
+                    std::cout << "Could not open book " << argv[firstArgument] << std::endl;
+                    return 1;
+                }
+            } else if (OPTION == "--psqt" && firstArgument + 1 < argc) {
+                if (!loadPieceSquareTables(argv[++firstArgument])) {
+                    std::cout << "Could not load piece square tables from " << argv[firstArgument] << std::endl;
+                    return 1;
+                }
+            } else {
+                break;
+            }
+            ++firstArgument;
+        }
+    } catch (const std::logic_error&) {
+        std::cout << "Invalid number for " << argv[firstArgument - 1] << std::endl;
+        return 1;
+    }
+    TranspositionTable table(hashMB);
+    
+    if (argc > firstArgument) {
+        try {
+            return runCommand(std::vector<std::string>(argv + firstArgument, argv + argc), table, threads, options, book);
+        } catch (const std::logic_error&) {
+            std::cout << "Invalid number in " << argv[firstArgument] << " arguments" << std::endl;
+            return 1;
+        }
+    }
+    
     const GameType GAME_TYPE = getGameType();
+    if (GAME_TYPE == UCI) {
+        Uci uci1(table, threads, options, book);
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        uci1.execute("uci");
+        uci1.loop();
+        return 0;
+    }
     const OpponentType OPPONENT_TYPE = getOpponent();
     const PlayerColor PLAYER_COLOR = OPPONENT_TYPE == ENGINE ? getPlayerColor() : WHITE;
-    const int DEPTH = OPPONENT_TYPE == ENGINE ? getEngineDepth() : 0;
+    SearchLimits limits;
+    limits.moveTime = OPPONENT_TYPE == ENGINE ? getEngineTime() : 0;
     
-    Board board1(GAME_TYPE);
-    Evaluate evaluate1;
-    Moves moves1(whiteRooks, blackRooks);
-    board1.displayBoard(0, evaluate1.materialScore(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens), evaluate1.evaluate(true, 0, moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing));
+    Board board1(GAME_TYPE == CHESS960);
+    Position position = board1.arrayToPosition();
+    Evaluate evaluate1(table);
+    ParallelSearch search1(table, threads);
+    options.chess960 = GAME_TYPE == CHESS960;
+    search1.setOptions(options);
+    Moves moves1;
+    board1.displayBoard(position, 0, evaluate1.materialScore(position), evaluate1.evaluate(moves1, position));
     
-    bool whiteTurn = true;
     int halfTurns = 2;
-    float score = 0;
+    Score score = 0;
     
     //begin main game loop playing against engine
-    while (OPPONENT_TYPE == ENGINE && !evaluate1.gameOver(whiteTurn, moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing)) {
-        const bool PLAYER_TURN = (whiteTurn && PLAYER_COLOR == WHITE)
-                            || (!whiteTurn && PLAYER_COLOR != WHITE);
-        if (!PLAYER_TURN) {
-            score = evaluate1.minimax(DEPTH, std::numeric_limits<float>::lowest(), std::numeric_limits<float>::max(), whiteTurn, true, moves1, enPassant, whitePawns,  whiteKnights,  whiteBishops, whiteRooks,  whiteQueens,  whiteKing, blackPawns,  blackKnights,  blackBishops, blackRooks,  blackQueens,  blackKing);
+    while (OPPONENT_TYPE == ENGINE && !evaluate1.gameOver(moves1, position)) {
+        const bool PLAYER_TURN = (position.whiteTurn && PLAYER_COLOR == WHITE)
+                            || (!position.whiteTurn && PLAYER_COLOR != WHITE);
+        // a book move skips the search, the book only knows standard chess
+        Move bookMove = NULL_MOVE;
+        if (!PLAYER_TURN && GAME_TYPE == CHESS) {
+            bookMove = book.probe(moves1, position, BOOK_WEIGHTED);
+        }
+        if (!PLAYER_TURN && bookMove == NULL_MOVE) {
+            search1.search(limits, position);
+            score = search1.getBestScore();
         }
-        const std::string MOVE = PLAYER_TURN ? getPlayerMove(whiteTurn, moves1)
-            : evaluate1.getBestMove();
-        moves1.doMove(MOVE, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        board1.displayBoard(halfTurns, evaluate1.materialScore(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens), score);
+        const Move MOVE = PLAYER_TURN ? getPlayerMove(moves1, position)
+            : bookMove != NULL_MOVE ? bookMove : search1.getBestMove();
+        moves1.doMove(MOVE, position);
+        position.trimHistory();
+        board1.displayBoard(position, halfTurns, evaluate1.materialScore(position), score);
         
-        whiteTurn = !whiteTurn;
         halfTurns++;
     }
     
     //begin main game loop playing against player
-    while (OPPONENT_TYPE == PLAYER && !evaluate1.gameOver(whiteTurn, moves1, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing)) {
-        const std::string MOVE = getPlayerMove(whiteTurn, moves1);
-        moves1.doMove(MOVE, enPassant, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        board1.displayBoard(halfTurns, evaluate1.materialScore(whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens), score);
+    while (OPPONENT_TYPE == PLAYER && !evaluate1.gameOver(moves1, position)) {
+        const Move MOVE = getPlayerMove(moves1, position);
+        moves1.doMove(MOVE, position);
+        position.trimHistory();
+        board1.displayBoard(position, halfTurns, evaluate1.materialScore(position), score);
         
-        whiteTurn = !whiteTurn;
         halfTurns++;
     }
     
-    const bool BLACK_CHECKED = blackKing & moves1.otherThreats(true, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-    const bool WHITE_CHECKED = whiteKing & moves1.otherThreats(false, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-    if (!whiteTurn && BLACK_CHECKED) {
+    const bool CHECKED = moves1.inCheck(position);
+    const bool NO_MOVES = !moves1.hasLegalMove(position);
+    if (!position.whiteTurn && CHECKED && NO_MOVES) {
         std::cout << "White wins!";
-    } else if (whiteTurn && WHITE_CHECKED) {
+    } else if (position.whiteTurn && CHECKED && NO_MOVES) {
         std::cout << "Black wins!";
-    } else {
+    } else if (NO_MOVES) {
         std::cout << "It's a stalemate!";
+    } else {
+        std::cout << "It's a draw!";
     }
     
     return 0;
     
-}
+}
\ No newline at end of file
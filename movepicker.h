@@ -0,0 +1,186 @@
+/**
+ * Purpose: Hand out a node's moves best first, generating each group only when it is reached
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <algorithm>
+#ifndef MOVEPICKER_H
+#define MOVEPICKER_H
+#include <stdint.h>
+#include "board.h"
+#include "moves.h"
+
+// the order moves come out in, a cutoff in an early stage means later ones are never generated
+enum PickStage {
+    HASH_STAGE, CAPTURE_GEN_STAGE, CAPTURE_STAGE, KILLER_STAGE,
+    QUIET_GEN_STAGE, QUIET_STAGE, BAD_CAPTURE_STAGE, DONE_STAGE
+};
+
+// quiet moves that caused a cutoff, scored by how much search they saved, indexed [color][from][to]
+typedef int HistoryTable[2][64][64];
+
+class MovePicker {
+private:
+    Moves& moves1;
+    const Position& position;
+    const bool includeQuiets; // quiescence search only wants captures that don't lose material
+    int stage;
+    
+    // hash move and killers come from other positions, so they are checked for legality first
+    // and skipped when the generators make them again
+    Move hashMove;
+    Move killers[2];
+    int killerIndex = 0;
+    const int (*history)[64];
+    
+    MoveList moveList;
+    int orderScores[256];
+    int index = 0;
+    
+    // captures the exchange on their square says lose material, kept for after the quiet moves
+    MoveList badCaptures;
+    int badIndex = 0;
+    
+    bool triedEarly(const Move MOVE) const {
+        return MOVE == hashMove || (includeQuiets && (MOVE == killers[0] || MOVE == killers[1]));
+    }
+    
+    // swap the highest scored remaining move to the front of what's left and return it
+    Move pickBest() {
+        int best = index;
+        for (int i = index + 1; i < moveList.size; ++i) {
+            if (orderScores[i] > orderScores[best]) {
+                best = i;
+            }
+        }
+        std::swap(moveList.moves[index], moveList.moves[best]);
+        std::swap(orderScores[index], orderScores[best]);
+        return moveList[index++];
+    }
+    
+public:
+    // picker for the main search, KILLERS are the quiet cutoff moves at this ply
+    MovePicker(Moves& moves1, const Position& position, const Move HASH_MOVE, const Move KILLERS[2],
+        const HistoryTable& HISTORY) : moves1(moves1), position(position), includeQuiets(true), stage(HASH_STAGE),
+        hashMove(HASH_MOVE), history(HISTORY[position.whiteTurn]) {
+        killers[0] = KILLERS[0];
+        killers[1] = KILLERS[1];
+    }
+    
+    // picker for quiescence search, captures and promotions that don't lose material, or every
+    // evasion when in check
+    MovePicker(Moves& moves1, const Position& position, const bool IN_CHECK) : moves1(moves1), position(position),
+        includeQuiets(IN_CHECK), stage(CAPTURE_GEN_STAGE), hashMove(NULL_MOVE), killers{ NULL_MOVE, NULL_MOVE }, history(nullptr) {}
+    
+    // next move to search, NULL_MOVE once every move has been handed out
+    Move next() {
+        switch (stage) {
+        case HASH_STAGE:
+            stage = CAPTURE_GEN_STAGE;
+            if (hashMove != NULL_MOVE && moves1.isLegal(hashMove, position)) {
+                return hashMove;
+            }
+            hashMove = NULL_MOVE;
+            [[fallthrough]];
+        
+        case CAPTURE_GEN_STAGE:
+            moves1.possibleCaptures(moveList, position);
+            for (int i = 0; i < moveList.size; ++i) {
+                orderScores[i] = mvvLva(moveList[i], position);
+            }
+            stage = CAPTURE_STAGE;
+            [[fallthrough]];
+        
+        case CAPTURE_STAGE:
+            while (index < moveList.size) {
+                const Move MOVE = pickBest();
+                if (MOVE == hashMove) {
+                    continue;
+                }
+                
+                // taking something worth at least the attacker can't lose, only the rest need an exchange
+                if (!winsMaterial(MOVE) && moves1.see(MOVE, position) < 0) {
+                    badCaptures.add(MOVE);
+                    continue;
+                }
+                return MOVE;
+            }
+            if (!includeQuiets) {
+                stage = DONE_STAGE;
+                return NULL_MOVE;
+            }
+            stage = history ? KILLER_STAGE : QUIET_GEN_STAGE;
+            return next();
+        
+        case KILLER_STAGE:
+            // a killer only counts if it is still a legal quiet move here
+            while (killerIndex < 2) {
+                const Move KILLER = killers[killerIndex++];
+                if (KILLER != NULL_MOVE && KILLER != hashMove && isQuiet(KILLER, position) && moves1.isLegal(KILLER, position)) {
+                    return KILLER;
+                }
+            }
+            stage = QUIET_GEN_STAGE;
+            [[fallthrough]];
+        
+        case QUIET_GEN_STAGE:
+            moveList.size = 0;
+            index = 0;
+            moves1.possibleQuietMoves(moveList, position);
+            for (int i = 0; i < moveList.size; ++i) {
+                orderScores[i] = history ? history[moveStart(moveList[i])][moveEnd(moveList[i])] : 0;
+            }
+            stage = QUIET_STAGE;
+            [[fallthrough]];
+        
+        case QUIET_STAGE:
+            while (index < moveList.size) {
+                const Move MOVE = pickBest();
+                if (!triedEarly(MOVE)) {
+                    return MOVE;
+                }
+            }
+            stage = BAD_CAPTURE_STAGE;
+            [[fallthrough]];
+        
+        case BAD_CAPTURE_STAGE:
+            if (badIndex < badCaptures.size) {
+                return badCaptures[badIndex++];
+            }
+            stage = DONE_STAGE;
+            [[fallthrough]];
+        
+        default:
+            return NULL_MOVE;
+        }
+    }
+    
+    // whether the captured piece is worth at least the one taking it, a legal king capture is never
+    // taken back so it always counts
+    bool winsMaterial(const Move MOVE) const {
+        if (moveFlag(MOVE) == EN_PASSANT) {
+            return true;
+        }
+        const int VICTIM = position.mailbox[moveEnd(MOVE)];
+        return VICTIM != NO_PIECE && std::abs(PIECE_VALUES[VICTIM]) >= std::abs(PIECE_VALUES[position.mailbox[moveStart(MOVE)]]);
+    }
+    
+    // most valuable victim, least valuable attacker, so cheap pieces taking big ones go first
+    static int mvvLva(const Move MOVE, const Position& position) {
+        const int VICTIM = capturedPiece(MOVE, position);
+        const int VICTIM_RANK = VICTIM == NO_PIECE ? 0 : VICTIM % 6 + 1;
+        const int PROMOTION_RANK = isPromotion(MOVE) ? moveFlag(MOVE) - PROMOTE_N + 2 : 0;
+        return 8 * (VICTIM_RANK + PROMOTION_RANK) - position.mailbox[moveStart(MOVE)] % 6;
+    }
+    
+    // a move that neither captures nor promotes, castles land on their own rook so they count
+    static bool isQuiet(const Move MOVE, const Position& position) {
+        return moveFlag(MOVE) == CASTLE || (position.mailbox[moveEnd(MOVE)] == NO_PIECE
+            && moveFlag(MOVE) != EN_PASSANT && !isPromotion(MOVE));
+    }
+};
+
+#endif
@@ -12,393 +12,602 @@
 #ifndef MOVES_H
 #define MOVES_H
 #include <stdint.h>
-#include <vector>
 #include <stdint.h>
+#include <cassert>
+#include "board.h"
+#include "attacks.h"
+#include "stats.h"
 
-typedef uint64_t Bitboard;
+// moves are packed into 16 bits as start square (bits 0-5), end square (bits 6-11)
+// and a flag (bits 12-15) marking double pushes, castles, en passant and promotions.
+// castles are stored as the king moving onto its own rook so chess960 castles are never ambiguous
+typedef uint16_t Move;
+
+enum MoveFlag {
+    NORMAL, DOUBLE_PUSH, CASTLE, EN_PASSANT,
+    PROMOTE_N, PROMOTE_B, PROMOTE_R, PROMOTE_Q
+};
+
+const Move NULL_MOVE = 0;
+
+constexpr Move makeMove(const int START, const int END, const int FLAG = NORMAL) {
+    return START | END << 6 | FLAG << 12;
+}
+
+constexpr int moveStart(const Move move) {
+    return move & 63;
+}
+
+constexpr int moveEnd(const Move move) {
+    return move >> 6 & 63;
+}
+
+constexpr int moveFlag(const Move move) {
+    return move >> 12;
+}
+
+constexpr bool isPromotion(const Move move) {
+    return moveFlag(move) >= PROMOTE_N;
+}
+
+// castling always ends with the king on the g or c file and the rook next to it on the inside
+constexpr int castleKingEnd(const Move move) {
+    return (moveStart(move) & 56) + (moveEnd(move) > moveStart(move) ? 6 : 2);
+}
+
+constexpr int castleRookEnd(const Move move) {
+    return (moveStart(move) & 56) + (moveEnd(move) > moveStart(move) ? 5 : 3);
+}
+
+// convert a move to long algebraic notation like e2e4 or e7e8q. castles show where the king lands,
+// or in chess960 the king taking its own rook since the king might not move at all
+inline std::string moveToAlgebraic(const Move MOVE, const bool CHESS960 = false) {
+    const int START = moveStart(MOVE);
+    const int END = moveFlag(MOVE) == CASTLE && !CHESS960 ? castleKingEnd(MOVE) : moveEnd(MOVE);
+    std::string algebraic = { char('a' + START % 8), char('8' - START / 8), char('a' + END % 8), char('8' - END / 8) };
+    if (isPromotion(MOVE)) {
+        algebraic += "nbrq"[moveFlag(MOVE) - PROMOTE_N];
+    }
+    return algebraic;
+}
+
+// the piece a move takes, NO_PIECE if it takes nothing. en passant takes a pawn that isn't on the
+// end square, and a castle ends on its own rook without taking it
+inline int capturedPiece(const Move MOVE, const Position& position) {
+    if (moveFlag(MOVE) == EN_PASSANT) {
+        return position.whiteTurn ? BLACK_PAWN : WHITE_PAWN;
+    }
+    return moveFlag(MOVE) == CASTLE ? static_cast<int>(NO_PIECE) : position.mailbox[moveEnd(MOVE)];
+}
+
+// every square on the line from START to END including both, both must share a rank
+constexpr Bitboard squaresFromTo(const int START, const int END) {
+    return (~0ULL >> (63 - std::max(START, END))) & (~0ULL << std::min(START, END));
+}
+
+// squares strictly between two squares and the whole line through them, empty if they don't share
+// a rank, file or diagonal
+struct LineTables {
+    Bitboard between[64][64];
+    Bitboard line[64][64];
+};
+
+constexpr LineTables makeLineTables() {
+    LineTables tables = {};
+    constexpr int DIRECTIONS[8][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1} };
+    for (int from = 0; from < 64; ++from) {
+        for (const auto& DIRECTION : DIRECTIONS) {
+            // the full line runs both ways from the square
+            Bitboard line = 1ULL << from;
+            for (int sign = -1; sign <= 1; sign += 2) {
+                for (int x = from % 8 + sign * DIRECTION[0], y = from / 8 + sign * DIRECTION[1];
+                        x >= 0 && x < 8 && y >= 0 && y < 8; x += sign * DIRECTION[0], y += sign * DIRECTION[1]) {
+                    line |= 1ULL << (x + 8 * y);
+                }
+            }
+            
+            Bitboard between = 0;
+            for (int x = from % 8 + DIRECTION[0], y = from / 8 + DIRECTION[1];
+                    x >= 0 && x < 8 && y >= 0 && y < 8; x += DIRECTION[0], y += DIRECTION[1]) {
+                tables.between[from][x + 8 * y] = between;
+                tables.line[from][x + 8 * y] = line;
+                between |= 1ULL << (x + 8 * y);
+            }
+        }
+    }
+    return tables;
+}
+
+inline constexpr LineTables LINES = makeLineTables();
+
+// fixed size list of moves that lives on the stack, 256 is above the most moves any position has
+struct MoveList {
+    Move moves[256];
+    int size = 0;
+    
+    void add(const Move move) {
+        moves[size++] = move;
+    }
+    
+    Move operator[](const int i) const {
+        return moves[i];
+    }
+    
+    const Move* begin() const {
+        return moves;
+    }
+    
+    const Move* end() const {
+        return moves + size;
+    }
+    
+    // swap move to the front so it is searched first, does nothing if it isn't in the list
+    void moveToFront(const Move move) {
+        for (int i = 0; i < size; ++i) {
+            if (moves[i] == move) {
+                std::swap(moves[0], moves[i]);
+                return;
+            }
+        }
+    }
+};
+
+// which moves a generator call makes, noisy moves are captures and promotions and quiet moves
+// are everything else, so the two together are every move
+enum GenType { ALL_MOVES, NOISY_MOVES, QUIET_MOVES };
+
+// what legal move generation needs to know about the side to move
+struct MoveMasks {
+    Bitboard own;
+    Bitboard enemy;
+    Bitboard occupied;
+    Bitboard checkers; // enemy pieces giving check
+    Bitboard targets;  // squares a piece other than the king may move to
+    Bitboard pinned;   // own pieces that can only move along the line to their king
+    int kingLoc;
+    
+    bool doubleCheck() const {
+        return checkers & (checkers - 1);
+    }
+};
 
 class Moves {
 private:
     // save row masks for moves
-    const Bitboard RANK_1 = -72057594037927936L;
-    const Bitboard RANK_4 = 1095216660480L;;
-    const Bitboard RANK_5 = 4278190080L;;
-    const Bitboard RANK_8 = 255L;
+    static constexpr Bitboard RANK_1 = -72057594037927936L;
+    static constexpr Bitboard RANK_4 = 1095216660480L;;
+    static constexpr Bitboard RANK_5 = 4278190080L;;
+    static constexpr Bitboard RANK_8 = 255L;
     
     // save column masks for moves
-    const Bitboard FILE_A = 72340172838076673L;
-    const Bitboard FILE_AB = 217020518514230019L;
-    const Bitboard FILE_H = -9187201950435737472L;
-    const Bitboard FILE_GH = -4557430888798830400L;
-    
-    // masks for knight and king moves
-    const Bitboard KNIGHT_SPAN = 43234889994L;
-    const Bitboard KING_SPAN = 460039L;
-    
-    // Bitboard masks for ranks and files
-    const Bitboard RANK_MASKS[8] = {
-        0xFF, 0xFF00, 0xFF0000, 0xFF000000, 0xFF00000000, 0xFF0000000000, 
-        0xFF000000000000, 0xFF00000000000000
-    };
-    
-    const Bitboard FILE_MASKS[8] = {
-        0x0101010101010101, 0x0202020202020202, 0x0404040404040404,
-        0x0808080808080808, 0x1010101010101010, 0x2020202020202020,
-        0x4040404040404040, 0x8080808080808080
-    };
-    
-    // Bitboard masks for diagonals
-    const Bitboard DIAGONAL_MASKS1[15] = {
-        0x1L, 0x102L, 0x10204L, 0x1020408L, 0x102040810L, 0x10204081020L, 
-        0x1020408102040L, 0x102040810204080L, 0x204081020408000L, 
-        0x408102040800000L, 0x810204080000000L, 0x1020408000000000L, 
-        0x2040800000000000L, 0x4080000000000000L, 0x8000000000000000L
-    };
-    
-    const Bitboard DIAGONAL_MASKS2[15] = {
-        0x80L, 0x8040L, 0x804020L, 0x80402010L, 0x8040201008L, 0x804020100804L, 
-        0x80402010080402L, 0x8040201008040201L, 0x4020100804020100L, 
-        0x2010080402010000L, 0x1008040201000000L, 0x804020100000000L, 
-        0x402010000000000L, 0x201000000000000L, 0x100000000000000L
-    };
-    
-    bool whiteShortCastle;
-    bool whiteLongCastle;
-    bool blackShortCastle;
-    bool blackLongCastle;
-    
-    Bitboard whiteLeftRook;
-    Bitboard whiteRightRook;
-    Bitboard blackLeftRook;
-    Bitboard blackRightRook;
-    
-    struct moveData {
-        char type1;
-        char type2;
-        char type3;
-        Bitboard board1;
-        Bitboard board2;
-        Bitboard board3;
-        bool whiteShortCastle;
-        bool whiteLongCastle;
-        bool blackShortCastle;
-        bool blackLongCastle;
-    };
-    
-    std::vector<moveData> moveHistory;
+    static constexpr Bitboard FILE_A = 72340172838076673L;
+    static constexpr Bitboard FILE_H = -9187201950435737472L;
+    
+    // piece values in hundredths of a pawn for exchanges indexed by piece type, the king is worth
+    // more than anything it could win
+    static constexpr int SEE_VALUES[6] = { 100, 300, 300, 500, 900, 10000 };
     
 public:
-    Moves(Bitboard whiteRooks, Bitboard blackRooks) {
-        // castling is legal at the start of games
-        whiteShortCastle = true;
-        whiteLongCastle = true;
-        blackShortCastle = true;
-        blackLongCastle = true;
+    // make move in place, saving what undoMove needs on the position undo stack
+    void doMove(const Move move, Position& position) {
+        PROFILE_PHASE(MAKE_MOVE);
+#ifdef DEBUG_CHECKS
+        assert(position.undoSize < MAX_HISTORY);
+#endif
+        UndoData& undoData = position.undoStack[position.undoSize++];
+        undoData.castleRights = position.castleRights;
+        undoData.halfmoveClock = position.halfmoveClock;
+        undoData.enPassant = position.enPassant;
+        undoData.key = position.key;
+        
+        // grab squares and flag from packed move
+        const int FLAG = moveFlag(move);
+        const int START = moveStart(move);
+        const int END = moveEnd(move);
+        const Bitboard START_SQUARE = 1ULL << START;
+        const Bitboard END_SQUARE = 1ULL << END;
+        const int PIECE_TYPE = position.mailbox[START];
+        const bool WHITE_MOVED = isWhitePiece(PIECE_TYPE);
+        
+        // take castle rights and en passant out of the key until they are updated
+        position.key ^= position.castleKey() ^ position.enPassantKey();
+        
+        // castle by lifting king and rook before placing them, in chess960 their squares can overlap
+        if (FLAG == CASTLE) {
+            const int ROOK_TYPE = position.mailbox[END];
+            position.removePiece(START);
+            position.removePiece(END);
+            position.addPiece(PIECE_TYPE, castleKingEnd(move));
+            position.addPiece(ROOK_TYPE, castleRookEnd(move));
+            position.castleRights &= WHITE_MOVED ? ~(WHITE_SHORT_CASTLE | WHITE_LONG_CASTLE)
+                                                : ~(BLACK_SHORT_CASTLE | BLACK_LONG_CASTLE);
+            undoData.capturedPiece = NO_PIECE;
+            position.enPassant = 0;
+        } else {
+            // remove captured piece, en passant captures the pawn that double pushed
+            const int CAPTURE_SQUARE = FLAG == EN_PASSANT ? __builtin_ctzll(position.enPassant) : END;
+            undoData.capturedPiece = position.mailbox[CAPTURE_SQUARE];
+            if (undoData.capturedPiece != NO_PIECE) {
+                position.removePiece(CAPTURE_SQUARE);
+            }
+            
+            // move piece, then swap pawn for the promoted piece
+            position.movePiece(START, END);
+            if (isPromotion(move)) {
+                position.removePiece(END);
+                position.addPiece((WHITE_MOVED ? WHITE_KNIGHT : BLACK_KNIGHT) + FLAG - PROMOTE_N, END);
+            }
+            
+            // update en passant
+            position.enPassant = FLAG == DOUBLE_PUSH ? END_SQUARE : 0;
+            
+            // moving the king or moving or capturing a starting rook loses castle rights
+            const Bitboard TOUCHED = START_SQUARE | END_SQUARE;
+            if (PIECE_TYPE == WHITE_KING) {
+                position.castleRights &= ~(WHITE_SHORT_CASTLE | WHITE_LONG_CASTLE);
+            } else if (PIECE_TYPE == BLACK_KING) {
+                position.castleRights &= ~(BLACK_SHORT_CASTLE | BLACK_LONG_CASTLE);
+            }
+            if (TOUCHED & position.whiteRightRook) {position.castleRights &= ~WHITE_SHORT_CASTLE;}
+            if (TOUCHED & position.whiteLeftRook) {position.castleRights &= ~WHITE_LONG_CASTLE;}
+            if (TOUCHED & position.blackRightRook) {position.castleRights &= ~BLACK_SHORT_CASTLE;}
+            if (TOUCHED & position.blackLeftRook) {position.castleRights &= ~BLACK_LONG_CASTLE;}
+        }
         
-        whiteLeftRook = whiteRooks & -whiteRooks;
-        whiteRightRook = whiteRooks ^ whiteLeftRook;
-        blackLeftRook = blackRooks & -blackRooks;
-        blackRightRook = blackRooks ^ blackLeftRook;
+        // captures and pawn moves can't be undone, so the clock and the repetition scan restart
+        const bool IRREVERSIBLE = FLAG != CASTLE && (undoData.capturedPiece != NO_PIECE || isPawn(PIECE_TYPE));
+        position.halfmoveClock = IRREVERSIBLE ? 0 : position.halfmoveClock + 1;
+        position.fullmoveNumber += !WHITE_MOVED;
+        
+        position.whiteTurn = !position.whiteTurn;
+        position.key ^= position.castleKey() ^ position.enPassantKey() ^ ZOBRIST.blackTurn;
+
+#ifdef DEBUG_CHECKS
+        assert(position.key == position.computeKey());
+        assert(position.pawnKey == position.computePawnKey());
+        assert(position.scoresMatchBoard());
+#endif
     }
     
-    void doMove(const std::string move, Bitboard& enPassant,
-        Bitboard& whitePawns, Bitboard& whiteKnights, Bitboard& whiteBishops, 
-        Bitboard& whiteRooks, Bitboard& whiteQueens, Bitboard& whiteKing,
-        Bitboard& blackPawns, Bitboard& blackKnights, Bitboard& blackBishops, 
-        Bitboard& blackRooks, Bitboard& blackQueens, Bitboard& blackKing) {
-        
-        moveData moveData;
-        moveData.whiteShortCastle = whiteShortCastle;
-        moveData.whiteLongCastle = whiteLongCastle;
-        moveData.blackShortCastle = whiteShortCastle;
-        moveData.blackLongCastle = whiteLongCastle;
-        
-        // grab coordinates from input string
-        const int X1 = move[1] - '0';
-        const int Y1 = move[2] - '0';
-        const int X2 = move[3] - '0';
-        const int Y2 = move[4] - '0';
-        const Bitboard START_SQUARE = 1L << (X1 + 8 * (7 - Y1));
-        const Bitboard END_SQUARE = 1L << (X2 + 8 * (7 - Y2));
-        
-        // set en passant temp and update en passant
-        const Bitboard EN_PASSANT_TEMP = enPassant;
-        const bool DOUBLE_PAWN_PUSH = (whitePawns | blackPawns) & START_SQUARE
-            && (START_SQUARE << 16 | START_SQUARE >> 16) & END_SQUARE;
-        enPassant = DOUBLE_PAWN_PUSH ? END_SQUARE : 0;
+    // take back the last move made on the position, which must be MOVE
+    void undoMove(const Move MOVE, Position& position) {
+        PROFILE_PHASE(MAKE_MOVE);
+        const UndoData& undoData = position.undoStack[--position.undoSize];
+        const int FLAG = moveFlag(MOVE);
+        const int START = moveStart(MOVE);
+        const int END = moveEnd(MOVE);
+        position.whiteTurn = !position.whiteTurn;
+        position.fullmoveNumber -= !position.whiteTurn;
+        position.castleRights = undoData.castleRights;
+        position.halfmoveClock = undoData.halfmoveClock;
+        position.enPassant = undoData.enPassant;
+        
+        if (FLAG == CASTLE) {
+            // put king and rook back on their starting squares
+            const int KING_TYPE = position.mailbox[castleKingEnd(MOVE)];
+            const int ROOK_TYPE = position.mailbox[castleRookEnd(MOVE)];
+            position.removePiece(castleKingEnd(MOVE));
+            position.removePiece(castleRookEnd(MOVE));
+            position.addPiece(KING_TYPE, START);
+            position.addPiece(ROOK_TYPE, END);
+        } else {
+            // demote promoted piece, move piece back and restore captured piece
+            if (isPromotion(MOVE)) {
+                position.removePiece(END);
+                position.addPiece(position.whiteTurn ? WHITE_PAWN : BLACK_PAWN, END);
+            }
+            position.movePiece(END, START);
+            if (undoData.capturedPiece != NO_PIECE) {
+                position.addPiece(undoData.capturedPiece, FLAG == EN_PASSANT ? __builtin_ctzll(undoData.enPassant) : END);
+            }
+        }
         
-        // mark which piece was captured, then remove it
-        const bool WHITE_DID_EN_PASSANT = EN_PASSANT_TEMP & END_SQUARE << 8  && whitePawns & START_SQUARE;
-        const bool BLACK_DID_EN_PASSANT = EN_PASSANT_TEMP & END_SQUARE >> 8 && blackPawns & START_SQUARE;
-        const char CAPTURED_PIECE_TYPE = (whitePawns & END_SQUARE) ? 'P' :
-                                        (whiteKnights & END_SQUARE) ? 'N' :
-                                        (whiteBishops & END_SQUARE) ? 'B' :
-                                        (whiteRooks & END_SQUARE) ? 'R' :
-                                        (whiteQueens & END_SQUARE) ? 'Q' :
-                                        (blackPawns & END_SQUARE) ? 'p' :
-                                        (blackKnights & END_SQUARE) ? 'n' :
-                                        (blackBishops & END_SQUARE) ? 'b' :
-                                        (blackRooks & END_SQUARE) ? 'r' :
-                                        (blackQueens & END_SQUARE) ? 'q' :
-                                        (BLACK_DID_EN_PASSANT) ? 'E' :
-                                        (WHITE_DID_EN_PASSANT) ? 'e' : 0;
-        moveData.type1 = CAPTURED_PIECE_TYPE;
-        switch (CAPTURED_PIECE_TYPE) {
-            case ('P'): moveData.board1 = whitePawns; whitePawns ^= END_SQUARE; break;
-            case ('N'): moveData.board1 = whiteKnights; whiteKnights ^= END_SQUARE; break;
-            case ('B'): moveData.board1 = whiteBishops; whiteBishops ^= END_SQUARE; break;
-            case ('R'): moveData.board1 = whiteRooks; whiteRooks ^= END_SQUARE;
-                whiteShortCastle &= !(END_SQUARE == whiteRightRook);
-                whiteLongCastle &= !(END_SQUARE == whiteLeftRook); break;
-            case ('Q'): moveData.board1 = whiteQueens; whiteQueens ^= END_SQUARE; break;
-            case ('p'): moveData.board1 = blackPawns; blackPawns ^= END_SQUARE; break;
-            case ('n'): moveData.board1 = blackKnights; blackKnights ^= END_SQUARE; break;
-            case ('b'): moveData.board1 = blackBishops; blackBishops ^= END_SQUARE; break;
-            case ('r'): moveData.board1 = blackRooks; blackRooks ^= END_SQUARE;
-                blackShortCastle &= !(END_SQUARE == blackRightRook);
-                blackLongCastle &= !(END_SQUARE == blackLeftRook); break;
-            case ('q'): moveData.board1 = blackQueens; blackQueens ^= END_SQUARE; break;
-            case ('E'): moveData.board1 = whitePawns; whitePawns ^= EN_PASSANT_TEMP; break;
-            case ('e'): moveData.board1 = blackPawns; blackPawns ^= EN_PASSANT_TEMP; break;
+        // the piece changes already reverted the piece keys, the saved key also covers the rest
+        position.key = undoData.key;
+
+#ifdef DEBUG_CHECKS
+        assert(position.key == position.computeKey());
+        assert(position.pawnKey == position.computePawnKey());
+        assert(position.scoresMatchBoard());
+#endif
+    }
+    
+    // pass the turn without moving, the search uses it to see if a position is good even for free
+    void doNullMove(Position& position) {
+        PROFILE_PHASE(MAKE_MOVE);
+#ifdef DEBUG_CHECKS
+        assert(position.undoSize < MAX_HISTORY);
+#endif
+        UndoData& undoData = position.undoStack[position.undoSize++];
+        undoData.capturedPiece = NO_PIECE;
+        undoData.castleRights = position.castleRights;
+        undoData.halfmoveClock = position.halfmoveClock;
+        undoData.enPassant = position.enPassant;
+        undoData.key = position.key;
+        
+        // positions on either side of a pass aren't a real repetition, so the scan stops here
+        position.key ^= position.enPassantKey() ^ ZOBRIST.blackTurn;
+        position.enPassant = 0;
+        position.whiteTurn = !position.whiteTurn;
+        position.halfmoveClock = 0;
+    }
+    
+    void undoNullMove(Position& position) {
+        PROFILE_PHASE(MAKE_MOVE);
+        const UndoData& undoData = position.undoStack[--position.undoSize];
+        position.whiteTurn = !position.whiteTurn;
+        position.halfmoveClock = undoData.halfmoveClock;
+        position.enPassant = undoData.enPassant;
+        position.key = undoData.key;
+    }
+    
+    // fill move list with every legal white move from the current position
+    void possibleMovesWhite(MoveList& moveList, const Position& position) {
+        PROFILE_PHASE(MOVE_GENERATION);
+        legalMoves(moveList, true, position);
+    }
+    
+    // fill move list with every legal black move from the current position
+    void possibleMovesBlack(MoveList& moveList, const Position& position) {
+        PROFILE_PHASE(MOVE_GENERATION);
+        legalMoves(moveList, false, position);
+    }
+    
+    // fill move list with the side to move's legal captures and promotions, never making a quiet move
+    void possibleCaptures(MoveList& moveList, const Position& position) {
+        PROFILE_PHASE(MOVE_GENERATION);
+        legalMoves(moveList, position.whiteTurn, position, NOISY_MOVES);
+    }
+    
+    // fill move list with the side to move's legal moves that don't capture or promote
+    void possibleQuietMoves(MoveList& moveList, const Position& position) {
+        PROFILE_PHASE(MOVE_GENERATION);
+        legalMoves(moveList, position.whiteTurn, position, QUIET_MOVES);
+    }
+    
+    // checkers and pinned pieces for the side to move, found once per node so moves don't have
+    // to be made to test them
+    MoveMasks moveMasks(const bool WHITE_MOVES, const Position& position) {
+        MoveMasks masks;
+        const int ENEMY_PIECE = WHITE_MOVES ? BLACK_PAWN : WHITE_PAWN;
+        masks.own = WHITE_MOVES ? position.whitePieces : position.blackPieces;
+        masks.enemy = WHITE_MOVES ? position.blackPieces : position.whitePieces;
+        masks.occupied = masks.own | masks.enemy;
+        masks.kingLoc = __builtin_ctzll(position.pieces[WHITE_MOVES ? WHITE_KING : BLACK_KING]);
+        masks.checkers = attackersTo(masks.kingLoc, masks.occupied, position) & masks.enemy;
+        
+        // in check every other move has to capture the checker or step between it and the king
+        masks.targets = ~masks.own & (masks.checkers
+            ? masks.checkers | LINES.between[masks.kingLoc][__builtin_ctzll(masks.checkers)] : ~0ULL);
+        
+        // a piece is pinned when it is the only piece between the king and an enemy slider
+        const Bitboard SNIPERS = (rookAttacks(masks.kingLoc, masks.enemy) & (position.pieces[ENEMY_PIECE + 3] | position.pieces[ENEMY_PIECE + 4]))
+            | (bishopAttacks(masks.kingLoc, masks.enemy) & (position.pieces[ENEMY_PIECE + 2] | position.pieces[ENEMY_PIECE + 4]));
+        masks.pinned = 0;
+        for (Bitboard snipers = SNIPERS; snipers; snipers &= snipers - 1) {
+            const Bitboard BLOCKERS = LINES.between[masks.kingLoc][__builtin_ctzll(snipers)] & masks.occupied;
+            if (!(BLOCKERS & (BLOCKERS - 1))) {
+                masks.pinned |= BLOCKERS & masks.own;
+            }
+        }
+        return masks;
+    }
+    
+    // only king moves, castles and en passant look up attacks on single squares. FROM limits which
+    // pieces move, other than en passant which is cheap enough to always make
+    void legalMoves(MoveList& moveList, const bool WHITE_MOVES, const Position& position, const GenType TYPE = ALL_MOVES,
+        const Bitboard FROM = ~0ULL) {
+        const MoveMasks MASKS = moveMasks(WHITE_MOVES, position);
+        const int FIRST_PIECE = WHITE_MOVES ? WHITE_PAWN : BLACK_PAWN;
+        const Bitboard KING = 1ULL << MASKS.kingLoc;
+        const bool KING_MOVES = FROM & KING;
+        
+        // pieces other than pawns capture on enemy squares and make quiet moves to empty ones
+        const Bitboard TYPE_MASK = TYPE == NOISY_MOVES ? MASKS.enemy : TYPE == QUIET_MOVES ? ~MASKS.enemy : ~0ULL;
+        const Bitboard TARGETS = MASKS.targets & TYPE_MASK;
+        
+        // in double check only the king can move
+        if (MASKS.doubleCheck()) {
+            if (KING_MOVES) {
+                possibleK(moveList, MASKS.kingLoc, ~MASKS.own & TYPE_MASK, MASKS.occupied ^ KING, MASKS.enemy, position);
+            }
+            return;
         }
         
-        // mark which piece was moved, then move it
-        const char PIECE_TYPE = (whitePawns     & START_SQUARE) ? 'P' :
-                                (whiteKnights   & START_SQUARE) ? 'N' :
-                                (whiteBishops   & START_SQUARE) ? 'B' :
-                                (whiteRooks     & START_SQUARE) ? 'R' :
-                                (whiteQueens    & START_SQUARE) ? 'Q' :
-                                (whiteKing      & START_SQUARE) ? 'K' :
-                                (blackPawns     & START_SQUARE) ? 'p' :
-                                (blackKnights   & START_SQUARE) ? 'n' :
-                                (blackBishops   & START_SQUARE) ? 'b' :
-                                (blackRooks     & START_SQUARE) ? 'r' :
-                                (blackQueens    & START_SQUARE) ? 'q' :
-                                (blackKing      & START_SQUARE) ? 'k' : 0;
-        moveData.type2 = PIECE_TYPE;
-        switch (PIECE_TYPE) {
-            case ('P'): moveData.board2 = whitePawns;    whitePawns   ^= START_SQUARE | END_SQUARE; break;
-            case ('N'): moveData.board2 = whiteKnights;  whiteKnights ^= START_SQUARE | END_SQUARE; break;
-            case ('B'): moveData.board2 = whiteBishops;  whiteBishops ^= START_SQUARE | END_SQUARE; break;
-            case ('R'): moveData.board2 = whiteRooks;    whiteRooks   ^= START_SQUARE | END_SQUARE;
-                whiteShortCastle &= !(START_SQUARE == whiteRightRook);
-                whiteLongCastle &= !(START_SQUARE == whiteLeftRook); break;
-            case ('Q'): moveData.board2 = whiteQueens;   whiteQueens  ^= START_SQUARE | END_SQUARE; break;
-            case ('K'): moveData.board2 = whiteKing;     whiteKing    ^= START_SQUARE | END_SQUARE; break;
-                whiteShortCastle = false; whiteLongCastle = false; break;
-            case ('p'): moveData.board2 = blackPawns;    blackPawns   ^= START_SQUARE | END_SQUARE; break;
-            case ('n'): moveData.board2 = blackKnights;  blackKnights ^= START_SQUARE | END_SQUARE; break;
-            case ('b'): moveData.board2 = blackBishops;  blackBishops ^= START_SQUARE | END_SQUARE; break;
-            case ('r'): moveData.board2 = blackRooks;    blackRooks   ^= START_SQUARE | END_SQUARE;
-                blackShortCastle &= !(START_SQUARE == blackRightRook);
-                blackLongCastle &= !(START_SQUARE == blackLeftRook); break;
-            case ('q'): moveData.board2 = blackQueens;   blackQueens  ^= START_SQUARE | END_SQUARE; break;
-            case ('k'): moveData.board2 = blackKing;     blackKing    ^= START_SQUARE | END_SQUARE;
-                blackShortCastle = false; blackLongCastle = false; break;
+        // pinned pieces can only move along the line through them and the king
+        const Bitboard PAWNS = position.pieces[FIRST_PIECE] & FROM;
+        possibleP(moveList, WHITE_MOVES, TYPE, MASKS.enemy, ~MASKS.occupied, MASKS.targets, PAWNS & ~MASKS.pinned);
+        for (Bitboard pinnedPawns = PAWNS & MASKS.pinned; pinnedPawns; pinnedPawns &= pinnedPawns - 1) {
+            possibleP(moveList, WHITE_MOVES, TYPE, MASKS.enemy, ~MASKS.occupied,
+                MASKS.targets & LINES.line[MASKS.kingLoc][__builtin_ctzll(pinnedPawns)], pinnedPawns & -pinnedPawns);
+        }
+        if (TYPE != QUIET_MOVES) {
+            possibleEnPassant(moveList, WHITE_MOVES, MASKS.kingLoc, MASKS.occupied, MASKS.enemy, position);
         }
         
-        // promote pawns
-        const bool MOVED_LEFT = __builtin_clzll(START_SQUARE) < __builtin_clzll(END_SQUARE);
-        moveData.type3 = move[0];
-        switch (move[0]) {
-            case ('N'): moveData.board3 = whiteKnights; whitePawns ^= END_SQUARE; whiteKnights |= END_SQUARE; break;
-            case ('B'): moveData.board3 = whiteBishops; whitePawns ^= END_SQUARE; whiteBishops |= END_SQUARE; break;
-            case ('R'): moveData.board3 = whiteRooks; whitePawns ^= END_SQUARE; whiteRooks |= END_SQUARE; break;
-            case ('Q'): moveData.board3 = whiteQueens; whitePawns ^= END_SQUARE; whiteQueens |= END_SQUARE; break;
-            case ('n'): moveData.board3 = blackKnights; blackPawns ^= END_SQUARE; blackKnights |= END_SQUARE; break;
-            case ('b'): moveData.board3 = blackBishops; blackPawns ^= END_SQUARE; blackBishops |= END_SQUARE; break;
-            case ('r'): moveData.board3 = blackRooks; blackPawns ^= END_SQUARE; blackRooks |= END_SQUARE; break;
-            case ('q'): moveData.board3 = blackQueens; blackPawns ^= END_SQUARE; blackQueens |= END_SQUARE; break;
-            case ('C'): moveData.board3 = whiteRooks;
-                whiteRooks ^= (MOVED_LEFT ? whiteLeftRook | whiteKing << 1 : whiteRightRook | whiteKing >> 1); break;
-            case ('c'): moveData.board3 = blackRooks;
-                blackRooks ^= (MOVED_LEFT ? blackLeftRook | blackKing << 1 : blackRightRook | blackKing >> 1); break;
+        // a pinned knight can never stay on the pin line
+        possibleN(moveList, TARGETS, position.pieces[FIRST_PIECE + 1] & ~MASKS.pinned & FROM);
+        possibleSliderMoves(moveList, 'b', TARGETS, MASKS.occupied, MASKS.pinned, MASKS.kingLoc, position.pieces[FIRST_PIECE + 2] & FROM);
+        possibleSliderMoves(moveList, 'r', TARGETS, MASKS.occupied, MASKS.pinned, MASKS.kingLoc, position.pieces[FIRST_PIECE + 3] & FROM);
+        possibleSliderMoves(moveList, 'q', TARGETS, MASKS.occupied, MASKS.pinned, MASKS.kingLoc, position.pieces[FIRST_PIECE + 4] & FROM);
+        if (KING_MOVES) {
+            possibleK(moveList, MASKS.kingLoc, ~MASKS.own & TYPE_MASK, MASKS.occupied ^ KING, MASKS.enemy, position);
         }
         
-        moveHistory.push_back(moveData);
+        if (!MASKS.checkers && TYPE != NOISY_MOVES && KING_MOVES) {
+            possibleCastles(moveList, WHITE_MOVES, MASKS.enemy, position);
+        }
     }
     
-    void undoMove(Bitboard& whitePawns, Bitboard& whiteKnights, Bitboard& whiteBishops, 
-                Bitboard& whiteRooks, Bitboard& whiteQueens, Bitboard& whiteKing,
-                Bitboard& blackPawns, Bitboard& blackKnights, Bitboard& blackBishops, 
-                Bitboard& blackRooks, Bitboard& blackQueens, Bitboard& blackKing) {
-        
-        const moveData moveData = moveHistory.back();
-        const std::vector<char> TYPES = {moveData.type1, moveData.type2, moveData.type3};
-        const std::vector<Bitboard> BOARDS = {moveData.board1, moveData.board2, moveData.board3};
-        whiteShortCastle = moveData.whiteShortCastle;
-        whiteLongCastle = moveData.whiteLongCastle;
-        blackShortCastle = moveData.blackShortCastle;
-        blackLongCastle = moveData.blackLongCastle;
-        moveHistory.pop_back();
-        
-        for (int i = 0; i < 3; ++i) {
-            switch (TYPES[i]) {
-                case ('E'):
-                case ('P'): whitePawns = BOARDS[i]; break;
-                case ('N'): whiteKnights = BOARDS[i]; break;
-                case ('B'): whiteBishops = BOARDS[i]; break;
-                case ('C'):
-                case ('R'): whiteRooks = BOARDS[i]; break;
-                case ('Q'): whiteQueens = BOARDS[i]; break;
-                case ('K'): whiteKing = BOARDS[i]; break;
-                case ('e'):
-                case ('p'): blackPawns = BOARDS[i]; break;
-                case ('n'): blackKnights = BOARDS[i]; break;
-                case ('b'): blackBishops = BOARDS[i]; break;
-                case ('c'):
-                case ('r'): blackRooks = BOARDS[i]; break;
-                case ('q'): blackQueens = BOARDS[i]; break;
-                case ('k'): blackKing = BOARDS[i]; break;
-            }
+    // true if the move is legal for the side to move, for moves that come from somewhere other
+    // than the generator like the transposition table. only the moving piece's moves are made
+    bool isLegal(const Move MOVE, const Position& position) {
+        PROFILE_PHASE(MOVE_GENERATION);
+        const int PIECE = position.mailbox[moveStart(MOVE)];
+        if (PIECE == NO_PIECE || isWhitePiece(PIECE) != position.whiteTurn) {
+            return false;
         }
+        MoveList moveList;
+        legalMoves(moveList, position.whiteTurn, position, ALL_MOVES, 1ULL << moveStart(MOVE));
+        return std::find(moveList.begin(), moveList.end(), MOVE) != moveList.end();
     }
     
-    // return a string of all possible white moves from the current posttion given all bitboards
-    // formatted as x1y1x2y2
-    std::string possibleMovesWhite(Bitboard enPassant,
-            Bitboard whitePawns, Bitboard whiteKnights, Bitboard whiteBishops, 
-            Bitboard whiteRooks, Bitboard whiteQueens, Bitboard whiteKing,
-            Bitboard blackPawns, Bitboard blackKnights, Bitboard blackBishops, 
-            Bitboard blackRooks, Bitboard blackQueens, Bitboard blackKing) {
-        
-        const Bitboard cantCapture = whitePawns | whiteKnights | whiteBishops | whiteRooks 
-            | whiteQueens | whiteKing | blackKing;
-        const Bitboard empty = ~(whitePawns | whiteKnights | whiteBishops | whiteRooks
-            | whiteQueens | whiteKing | blackPawns | blackKnights | blackBishops
-            | blackRooks | blackQueens | blackKing);
-        const Bitboard threats = otherThreats(false, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
-        
-        return possibleP(true, cantCapture, empty, enPassant, whitePawns)
-            + possibleN(cantCapture, whiteKnights)
-            + possibleSliderMoves('b', cantCapture, empty, whiteBishops)
-            + possibleSliderMoves('r', cantCapture, empty, whiteRooks)
-            + possibleSliderMoves('q', cantCapture, empty, whiteQueens)
-            + possibleK(cantCapture, empty, threats, whiteKing);
-    }
-    
-    // return a string of all possible black moves from the current posttion given all bitboards
-    // formatted as x1y1x2y2
-    std::string possibleMovesBlack(Bitboard enPassant,
-            Bitboard whitePawns, Bitboard whiteKnights, Bitboard whiteBishops, 
-            Bitboard whiteRooks, Bitboard whiteQueens, Bitboard whiteKing,
-            Bitboard blackPawns, Bitboard blackKnights, Bitboard blackBishops, 
-            Bitboard blackRooks, Bitboard blackQueens, Bitboard blackKing) {
+    // true as soon as one legal move for the side to move is found, without building the move list.
+    // king and piece moves are tried first since they need no move list at all
+    bool hasLegalMove(const Position& position) {
+        PROFILE_PHASE(MOVE_GENERATION);
+        const bool WHITE_MOVES = position.whiteTurn;
+        const MoveMasks MASKS = moveMasks(WHITE_MOVES, position);
+        const int FIRST_PIECE = WHITE_MOVES ? WHITE_PAWN : BLACK_PAWN;
+        
+        for (Bitboard kingMoves = kingAttacks(MASKS.kingLoc) & ~MASKS.own; kingMoves; kingMoves &= kingMoves - 1) {
+            if (!(attackersTo(__builtin_ctzll(kingMoves), MASKS.occupied ^ 1ULL << MASKS.kingLoc, position) & MASKS.enemy)) {
+                return true;
+            }
+        }
+        if (MASKS.doubleCheck()) {
+            return false;
+        }
         
-        const Bitboard cantCapture = blackPawns | blackKnights | blackBishops | blackRooks
-            | blackQueens | blackKing | whiteKing;
-        const Bitboard empty =
-            ~(whitePawns | whiteKnights | whiteBishops | whiteRooks | whiteQueens | whiteKing
-            | blackPawns | blackKnights | blackBishops | blackRooks | blackQueens | blackKing);
-        const Bitboard threats = otherThreats(true, whitePawns, whiteKnights, whiteBishops, whiteRooks, whiteQueens, whiteKing, blackPawns, blackKnights, blackBishops, blackRooks, blackQueens, blackKing);
+        for (Bitboard knights = position.pieces[FIRST_PIECE + 1] & ~MASKS.pinned; knights; knights &= knights - 1) {
+            if (knightAttacks(__builtin_ctzll(knights)) & MASKS.targets) {
+                return true;
+            }
+        }
+        for (int type = 2; type <= 4; ++type) {
+            for (Bitboard pieces = position.pieces[FIRST_PIECE + type]; pieces; pieces &= pieces - 1) {
+                const int PIECE_LOCATION = __builtin_ctzll(pieces);
+                Bitboard possibilities = ((type != 3 ? bishopAttacks(PIECE_LOCATION, MASKS.occupied) : 0)
+                    | (type != 2 ? rookAttacks(PIECE_LOCATION, MASKS.occupied) : 0)) & MASKS.targets;
+                if (MASKS.pinned & (pieces & -pieces)) {
+                    possibilities &= LINES.line[MASKS.kingLoc][PIECE_LOCATION];
+                }
+                if (possibilities) {
+                    return true;
+                }
+            }
+        }
         
-        return possibleP(false, cantCapture, empty, enPassant, blackPawns)
-            + possibleN(cantCapture, blackKnights) 
-            + possibleSliderMoves('b', cantCapture, empty, blackBishops)
-            + possibleSliderMoves('r', cantCapture, empty, blackRooks)
-            + possibleSliderMoves('q', cantCapture, empty, blackQueens)
-            + possibleK(cantCapture, empty, threats, blackKing);
+        // pawns and castles are rare last resorts, so they just use the normal generators
+        MoveList moveList;
+        const Bitboard PAWNS = position.pieces[FIRST_PIECE];
+        possibleP(moveList, WHITE_MOVES, ALL_MOVES, MASKS.enemy, ~MASKS.occupied, MASKS.targets, PAWNS & ~MASKS.pinned);
+        for (Bitboard pinnedPawns = PAWNS & MASKS.pinned; pinnedPawns && !moveList.size; pinnedPawns &= pinnedPawns - 1) {
+            possibleP(moveList, WHITE_MOVES, ALL_MOVES, MASKS.enemy, ~MASKS.occupied,
+                MASKS.targets & LINES.line[MASKS.kingLoc][__builtin_ctzll(pinnedPawns)], pinnedPawns & -pinnedPawns);
+        }
+        possibleEnPassant(moveList, WHITE_MOVES, MASKS.kingLoc, MASKS.occupied, MASKS.enemy, position);
+        if (!MASKS.checkers) {
+            possibleCastles(moveList, WHITE_MOVES, MASKS.enemy, position);
+        }
+        return moveList.size > 0;
     }
     
-    // return a string of all possible white pawn moves from the current posttion given white pawns
-    std::string possibleP(const bool WHITE_MOVES, Bitboard cantCapture, Bitboard empty, Bitboard enPassant, Bitboard pawns) {
-        std::string allMoves = "";
-        
+    // add pawn moves of the type landing on targets to the move list, black pawns are flipped so
+    // both colors push up
+    void possibleP(MoveList& moveList, const bool WHITE_MOVES, const GenType TYPE, Bitboard enemy, Bitboard empty,
+        Bitboard targets, Bitboard pawns) {
         if (!WHITE_MOVES) {
             empty = flipVertical(empty);
-            cantCapture = flipVertical(cantCapture);
-            enPassant = flipVertical(enPassant);
+            enemy = flipVertical(enemy);
+            targets = flipVertical(targets);
             pawns = flipVertical(pawns);
         }
         
+        // captures and every promotion are noisy, plain pushes are quiet
+        if (TYPE == QUIET_MOVES) {
+            enemy = 0;
+            empty &= ~RANK_8;
+        } else if (TYPE == NOISY_MOVES) {
+            empty &= RANK_8;
+        }
+        
+        // squares are flipped back for black when the move is added
+        const int FLIP = WHITE_MOVES ? 0 : 56;
+        
         // left capture
-        int row, col;
-        Bitboard pawnMoves = pawns >> 9 & (~empty | (enPassant >> 8)) & ~cantCapture & ~FILE_H & ~RANK_8;
+        int location;
+        Bitboard pawnMoves = pawns >> 9 & enemy & targets & ~FILE_H & ~RANK_8;
         while (pawnMoves) {
-            row = __builtin_ctzll(pawnMoves) % 8;
-            col = __builtin_ctzll(pawnMoves) / 8;
-            allMoves += " " + std::to_string(row + 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
+            location = __builtin_ctzll(pawnMoves);
+            moveList.add(makeMove((location + 9) ^ FLIP, location ^ FLIP));
             pawnMoves &= pawnMoves - 1;
         }
-        
+         
          // right capture
-        pawnMoves = pawns >> 7 & (~empty | (enPassant >> 8)) & ~cantCapture & ~FILE_A & ~RANK_8;
+        pawnMoves = pawns >> 7 & enemy & targets & ~FILE_A & ~RANK_8;
         while (pawnMoves) {
-            row = __builtin_ctzll(pawnMoves) % 8;
-            col = __builtin_ctzll(pawnMoves) / 8;
-            allMoves += " " + std::to_string(row - 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
+            location = __builtin_ctzll(pawnMoves);
+            moveList.add(makeMove((location + 7) ^ FLIP, location ^ FLIP));
             pawnMoves &= pawnMoves - 1;
         }
         
         // push once
-        pawnMoves = pawns >> 8 & empty & ~RANK_8;
+        pawnMoves = pawns >> 8 & empty & targets & ~RANK_8;
         while (pawnMoves) {
-            row = __builtin_ctzll(pawnMoves) % 8;
-            col = __builtin_ctzll(pawnMoves) / 8;
-            allMoves += " " + std::to_string(row) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
+            location = __builtin_ctzll(pawnMoves);
+            moveList.add(makeMove((location + 8) ^ FLIP, location ^ FLIP));
             pawnMoves &= pawnMoves - 1;
         }
         
         // push twice
-        pawnMoves = pawns >> 16 & RANK_4 & empty & empty >> 8;
+        pawnMoves = pawns >> 16 & RANK_4 & empty & empty >> 8 & targets;
         while (pawnMoves) {
-            row = __builtin_ctzll(pawnMoves) % 8;
-            col = __builtin_ctzll(pawnMoves) / 8;
-            allMoves += " " + std::to_string(row) + std::to_string(7 - (col + 2)) + std::to_string(row) + std::to_string(7 - col);
+            location = __builtin_ctzll(pawnMoves);
+            moveList.add(makeMove((location + 16) ^ FLIP, location ^ FLIP, DOUBLE_PUSH));
             pawnMoves &= pawnMoves - 1;
         }
         
         // left capture to promote
-        pawnMoves = pawns >> 9 & ~empty & ~cantCapture & ~FILE_H & RANK_8;
+        pawnMoves = pawns >> 9 & enemy & targets & ~FILE_H & RANK_8;
         while (pawnMoves) {
-            int row = __builtin_ctzll(pawnMoves) % 8;
-            int col = __builtin_ctzll(pawnMoves) / 8;
-            allMoves += "N" + std::to_string(row + 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "B" + std::to_string(row + 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "R" + std::to_string(row + 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "Q" + std::to_string(row + 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
+            location = __builtin_ctzll(pawnMoves);
+            addPromotions(moveList, (location + 9) ^ FLIP, location ^ FLIP);
             pawnMoves &= pawnMoves - 1;
         }
         
         // right capture to promote
-        pawnMoves = pawns >> 7 & ~empty & ~cantCapture & ~FILE_A & RANK_8;
+        pawnMoves = pawns >> 7 & enemy & targets & ~FILE_A & RANK_8;
         while (pawnMoves) {
-            int row = __builtin_ctzll(pawnMoves) % 8;
-            int col = __builtin_ctzll(pawnMoves) / 8;
-            allMoves += "N" + std::to_string(row - 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "B" + std::to_string(row - 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "R" + std::to_string(row - 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "Q" + std::to_string(row - 1) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
+            location = __builtin_ctzll(pawnMoves);
+            addPromotions(moveList, (location + 7) ^ FLIP, location ^ FLIP);
             pawnMoves &= pawnMoves - 1;
         }
         
         // push once to promote
-        pawnMoves = pawns >> 8 & empty & RANK_8;
+        pawnMoves = pawns >> 8 & empty & targets & RANK_8;
         while (pawnMoves) {
-            int row = __builtin_ctzll(pawnMoves) % 8;
-            int col = __builtin_ctzll(pawnMoves) / 8;
-            allMoves += "N" + std::to_string(row) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "B" + std::to_string(row) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "R" + std::to_string(row) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
-            allMoves += "Q" + std::to_string(row) + std::to_string(7 - (col + 1)) + std::to_string(row) + std::to_string(7 - col);
+            location = __builtin_ctzll(pawnMoves);
+            addPromotions(moveList, (location + 8) ^ FLIP, location ^ FLIP);
             pawnMoves &= pawnMoves - 1;
         }
-        
-        if (!WHITE_MOVES) {
-            std::string temp = "";
-            temp.reserve(allMoves.length());
-            std::string lower;
-            int y1, y2;
-            for (int i = 0; i < allMoves.length(); i += 5) {
-                lower = std::tolower(allMoves[i]);
-                y1 = '7' - allMoves[i + 2];
-                y2 = '7' - allMoves[i + 4];
-                temp += lower + allMoves[i + 1] + std::to_string(y1) + allMoves[i + 3] + std::to_string(y2);
+    }
+    
+    // en passant removes two pawns from one rank, which pin masks can't see, so the king is
+    // checked for attacks on the board as it will be after the capture
+    void possibleEnPassant(MoveList& moveList, const bool WHITE_MOVES, const int KING_LOC,
+        const Bitboard OCCUPIED, const Bitboard ENEMY, const Position& position) {
+        if (!position.enPassant) {
+            return;
+        }
+        const int CAPTURED = __builtin_ctzll(position.enPassant);
+        const int TARGET = WHITE_MOVES ? CAPTURED - 8 : CAPTURED + 8;
+        Bitboard attackers = pawnAttacks(!WHITE_MOVES, TARGET) & position.pieces[WHITE_MOVES ? WHITE_PAWN : BLACK_PAWN];
+        while (attackers) {
+            const int START = __builtin_ctzll(attackers);
+            const Bitboard AFTER = (OCCUPIED ^ 1ULL << START ^ position.enPassant) | 1ULL << TARGET;
+            if (!(attackersTo(KING_LOC, AFTER, position) & ENEMY & ~position.enPassant)) {
+                moveList.add(makeMove(START, TARGET, EN_PASSANT));
             }
-            allMoves = temp;
+            attackers &= attackers - 1;
         }
-        
-        return allMoves;
+    }
+    
+    void addPromotions(MoveList& moveList, const int START, const int END) {
+        moveList.add(makeMove(START, END, PROMOTE_N));
+        moveList.add(makeMove(START, END, PROMOTE_B));
+        moveList.add(makeMove(START, END, PROMOTE_R));
+        moveList.add(makeMove(START, END, PROMOTE_Q));
     }
     
     constexpr Bitboard flipVertical(const Bitboard b) {
@@ -412,227 +621,207 @@ public:
             | (b >> 56);
     }
     
-    // return a string of all possible knight moves from the current posttion given knights
-    std::string possibleN(const Bitboard cantCapture, Bitboard knights) {
-        std::string allMoves = "";
-        
-        int possibilityLoc;
-        int knightLoc;
-        while(knights) {
-            knightLoc = __builtin_ctzll(knights);
-            Bitboard possibility = 0;
-            // shift in correct direction
-            possibility = knightLoc > 18 ?
-                        KNIGHT_SPAN << (knightLoc - 18) :
-                        KNIGHT_SPAN >> (18 - knightLoc);
-            
-            // get rid of overflow files and cant captures
-            possibility &= knightLoc % 8 < 4 ?
-                        ~FILE_GH & ~cantCapture :
-                        ~FILE_AB & ~cantCapture;
-            
-            while (possibility) {
-                possibilityLoc = __builtin_ctzll(possibility);
-                allMoves += " " + std::to_string(knightLoc % 8) + std::to_string(7 - knightLoc / 8)
-                        + std::to_string(possibilityLoc % 8) + std::to_string(7 - possibilityLoc / 8);
-                possibility &= possibility - 1; // get rid of lowest
-            }
+    // add all knight moves landing on targets to the move list given knights
+    void possibleN(MoveList& moveList, const Bitboard targets, Bitboard knights) {
+        while (knights) {
+            const int KNIGHT_LOC = __builtin_ctzll(knights);
+            addMoves(moveList, KNIGHT_LOC, knightAttacks(KNIGHT_LOC) & targets);
             knights &= knights - 1; // get rid of smallest knight
         }
-        return allMoves;
     }
     
-    // return a string of all possible slider moves of the specified type from the current posttion
-    std::string possibleSliderMoves(const char PIECE_TYPE, const Bitboard cantCapture, const Bitboard empty, Bitboard pieces) {
-        std::string allMoves = "";
-        
-        Bitboard smallestPiece;
-        Bitboard possibilities;
-        int pieceLocation;
-        int possibilityLocation;
+    // add all slider moves of the specified type landing on targets to the move list
+    void possibleSliderMoves(MoveList& moveList, const char PIECE_TYPE, const Bitboard targets, const Bitboard occupied,
+        const Bitboard pinned, const int KING_LOC, Bitboard pieces) {
         while (pieces) {
-            pieceLocation = __builtin_ctzll(pieces);
-            smallestPiece = pieces & -pieces;
-            
-            if (PIECE_TYPE == 'b') { // if the pieces are bishops
-                possibilities = hypQuint(empty, smallestPiece, DIAGONAL_MASKS1[pieceLocation / 8 + pieceLocation % 8])
-                    | hypQuint(empty, smallestPiece, DIAGONAL_MASKS2[pieceLocation / 8 + 7 - pieceLocation % 8]);
-            } else if (PIECE_TYPE == 'r') { // if the pieces are rooks
-                possibilities = hypQuint(empty, smallestPiece, FILE_MASKS[pieceLocation % 8])
-                    | hypQuint(empty, smallestPiece, RANK_MASKS[pieceLocation / 8]);
-            } else { // if the pieces are queens
-                possibilities = hypQuint(empty, smallestPiece, DIAGONAL_MASKS1[pieceLocation / 8 + pieceLocation % 8])
-                    | hypQuint(empty, smallestPiece, DIAGONAL_MASKS2[pieceLocation / 8 + 7 - pieceLocation % 8])
-                    | hypQuint(empty, smallestPiece, FILE_MASKS[pieceLocation % 8])
-                    | hypQuint(empty, smallestPiece, RANK_MASKS[pieceLocation / 8]);
-            } possibilities &= ~cantCapture;
-            
-            while (possibilities) {
-                possibilityLocation = __builtin_ctzll(possibilities);
-                allMoves += " " + std::to_string( pieceLocation % 8 ) + std::to_string( 7 - pieceLocation / 8 )
-                        + std::to_string( possibilityLocation % 8 ) + std::to_string( 7 - possibilityLocation / 8 );
-                possibilities &= possibilities - 1;
+            const int PIECE_LOCATION = __builtin_ctzll(pieces);
+            Bitboard possibilities = PIECE_TYPE == 'b' ? bishopAttacks(PIECE_LOCATION, occupied)
+                : PIECE_TYPE == 'r' ? rookAttacks(PIECE_LOCATION, occupied)
+                : bishopAttacks(PIECE_LOCATION, occupied) | rookAttacks(PIECE_LOCATION, occupied);
+            possibilities &= targets;
+            if (pinned & (pieces & -pieces)) {
+                possibilities &= LINES.line[KING_LOC][PIECE_LOCATION];
             }
+            addMoves(moveList, PIECE_LOCATION, possibilities);
             pieces &= pieces - 1;
         }
-        return allMoves;
-    }
-    
-    // returns bitboard of all possible moves for chosen slider pieces given mask
-    constexpr Bitboard hypQuint(const Bitboard empty, const Bitboard square, const Bitboard mask) {
-        return ((((mask & ~empty) - (square * 2)) 
-            ^ reverse(reverse(mask & ~empty) - (reverse(square) * 2))))
-            & mask;
     }
     
-    // Reverse function for Hyperbola Quintessence
-    constexpr Bitboard reverse(Bitboard b) {
-        b = (b & 0x5555555555555555) << 1 | ((b >> 1) & 0x5555555555555555);
-        b = (b & 0x3333333333333333) << 2 | ((b >> 2) & 0x3333333333333333);
-        b = (b & 0x0f0f0f0f0f0f0f0f) << 4 | ((b >> 4) & 0x0f0f0f0f0f0f0f0f);
-        b = (b & 0x00ff00ff00ff00ff) << 8 | ((b >> 8) & 0x00ff00ff00ff00ff);
-    
-        return (b << 48) | ((b & 0xffff0000) << 16) | ((b >> 16) & 0xffff0000) | (b >> 48);
+    // add a move from start to every square in ends
+    void addMoves(MoveList& moveList, const int START, Bitboard ends) {
+        while (ends) {
+            moveList.add(makeMove(START, __builtin_ctzll(ends)));
+            ends &= ends - 1; // get rid of lowest
+        }
     }
     
-    // return a string of all possible king moves from the current posttion given king
-    std::string possibleK(const Bitboard cantCapture, const Bitboard empty, const Bitboard threats, const Bitboard king) {
-        std::string allMoves = "";
-        
-        const int KING_LOC = __builtin_ctzll(king);
-        Bitboard possibility = 0;
-        int possibilityLocation;
-        
-        // shift in correct direction
-        possibility = KING_LOC > 9 ? KING_SPAN << (KING_LOC - 9) :
-                                    KING_SPAN >> (9 - KING_LOC);
-        
-        // get rid of overflow files and illegal moves.
-        possibility &= KING_LOC % 8 < 4 ? ~FILE_GH : ~FILE_AB;
-        possibility &= ~(cantCapture | threats);
-        
+    // add king moves to squares in targets the enemy doesn't attack, occupied must leave out the
+    // king so a slider checking it also covers the square behind it
+    void possibleK(MoveList& moveList, const int KING_LOC, const Bitboard targets, const Bitboard occupied,
+        const Bitboard enemy, const Position& position) {
+        Bitboard possibility = kingAttacks(KING_LOC) & targets;
         while (possibility) {
-            possibilityLocation = __builtin_ctzll(possibility);
-            allMoves += " " + std::to_string(KING_LOC % 8) + std::to_string(7 - KING_LOC / 8)
-                    + std::to_string(possibilityLocation % 8) + std::to_string(7 - possibilityLocation / 8);
+            const int POSSIBILITY_LOCATION = __builtin_ctzll(possibility);
+            if (!(attackersTo(POSSIBILITY_LOCATION, occupied, position) & enemy)) {
+                moveList.add(makeMove(KING_LOC, POSSIBILITY_LOCATION));
+            }
             possibility &= possibility - 1; // get rid of lowest
         }
-        
-        possibility = 0;
-        const bool KING_FRONT_ROW = KING_LOC / 8 == 7;
-        if (KING_FRONT_ROW) {
-            if (whiteLongCastle) { // white long castle
-                possibility |= king >> 2 & empty & empty >> 1 & ~(threats >> 1);
+    }
+    
+    // add castles that still have rights, every square the king or rook crosses must be empty
+    // other than themselves and the king can't start in, cross or land on an attacked square.
+    // attacks are looked up without the king and rook since in chess960 either can be in the way
+    void possibleCastles(MoveList& moveList, const bool WHITE_MOVES, const Bitboard enemy, const Position& position) {
+        const Bitboard king = position.pieces[WHITE_MOVES ? WHITE_KING : BLACK_KING];
+        const int KING_LOC = __builtin_ctzll(king);
+        const int BACK_RANK = WHITE_MOVES ? 56 : 0;
+        const int RIGHTS[2] = {
+            WHITE_MOVES ? WHITE_SHORT_CASTLE : BLACK_SHORT_CASTLE,
+            WHITE_MOVES ? WHITE_LONG_CASTLE : BLACK_LONG_CASTLE
+        };
+        const Bitboard ROOKS[2] = {
+            WHITE_MOVES ? position.whiteRightRook : position.blackRightRook,
+            WHITE_MOVES ? position.whiteLeftRook : position.blackLeftRook
+        };
+        
+        for (int i = 0; i < 2; ++i) {
+            if (!(position.castleRights & RIGHTS[i])) {
+                continue;
             }
-            if (whiteShortCastle) { // white short castle
-                possibility |= king << 2 & empty & empty << 1 & ~(threats << 1);
+            const int ROOK_LOC = __builtin_ctzll(ROOKS[i]);
+            const Bitboard KING_PATH = squaresFromTo(KING_LOC, BACK_RANK + (i == 0 ? 6 : 2));
+            const Bitboard ROOK_PATH = squaresFromTo(ROOK_LOC, BACK_RANK + (i == 0 ? 5 : 3));
+            const Bitboard OTHERS = position.occupied() & ~(king | ROOKS[i]);
+            if ((KING_PATH | ROOK_PATH) & OTHERS) {
+                continue;
             }
-            possibility &= ~threats;
             
-            while (possibility) {
-                int possibilityLocation = __builtin_ctzll(possibility);
-                allMoves += "C" + std::to_string(KING_LOC % 8) + std::to_string(7 - KING_LOC / 8) 
-                        + std::to_string(possibilityLocation % 8) + std::to_string(7 - possibilityLocation / 8);
-                possibility &= possibility - 1; // get rid of lowest
+            bool attacked = false;
+            for (Bitboard path = KING_PATH; path && !attacked; path &= path - 1) {
+                attacked = attackersTo(__builtin_ctzll(path), OTHERS, position) & enemy;
             }
-        } else {
-            if (blackLongCastle) { // black long castle
-                possibility |= king >> 2 & empty & empty >> 1 & ~(threats >> 1);
-            }
-            if (blackShortCastle) { // black short castle
-                possibility |= king << 2 & empty & empty << 1 & ~(threats << 1);
-            }
-            possibility &= ~threats;
-            
-            while (possibility) {
-                int possibilityLocation = __builtin_ctzll(possibility);
-                allMoves += "c" + std::to_string(KING_LOC % 8) + std::to_string(7 - KING_LOC / 8) 
-                        + std::to_string(possibilityLocation % 8) + std::to_string(7 - possibilityLocation / 8);
-                possibility &= possibility - 1; // get rid of lowest
+            if (!attacked) {
+                moveList.add(makeMove(KING_LOC, ROOK_LOC, CASTLE));
             }
         }
-        
-        return allMoves;
     }
     
-    Bitboard otherThreats(const bool WHITES_THREATS,
-            const Bitboard whitePawns, const Bitboard whiteKnights, const Bitboard whiteBishops, 
-            const Bitboard whiteRooks, const Bitboard whiteQueens, const Bitboard whiteKing,
-            const Bitboard blackPawns, const Bitboard blackKnights, const Bitboard blackBishops, 
-            const Bitboard blackRooks, const Bitboard blackQueens, const Bitboard blackKing) {
-        
-        Bitboard pawns, knights, bishops, rooks, queens, king;
-        if (WHITES_THREATS) {
-            pawns = whitePawns; knights = whiteKnights;
-            bishops = whiteBishops; rooks = whiteRooks;
-            queens = whiteQueens; king = whiteKing;
-        } else {
-            pawns = blackPawns; knights = blackKnights;
-            bishops = blackBishops; rooks = blackRooks;
-            queens = blackQueens; king = blackKing;
-        }
-        
-        const Bitboard empty = ~(whitePawns | whiteKnights | whiteBishops | whiteRooks
-            | whiteQueens | whiteKing | blackPawns | blackKnights | blackBishops
-            | blackRooks | blackQueens | blackKing);
-        
-        Bitboard possibility = 0;
-        int pieceLocation;
-        Bitboard smallestPiece;
-        
-        // add pawn attacks
-        Bitboard allThreats = WHITES_THREATS ? (pawns >> 7 & ~FILE_A) | (pawns >> 9 & ~FILE_H)
-                                    : (pawns << 7 & ~FILE_H) | (pawns << 9 & ~FILE_A);
-        
-        // add knight attacks
-        while (knights) {
-            pieceLocation = __builtin_ctzll(knights);
-            possibility = (pieceLocation > 18 ? KNIGHT_SPAN << (pieceLocation - 18) 
-                : KNIGHT_SPAN >> (18 - pieceLocation));
-            possibility &= pieceLocation % 8 < 4 ? ~FILE_GH : ~FILE_AB;
-            allThreats |= possibility;
-            knights &= knights - 1;
+    // true if the side to move is in check
+    bool inCheck(const Position& position) {
+        PROFILE_PHASE(ATTACKS);
+        const bool WHITE_TURN = position.whiteTurn;
+        const int KING_LOC = __builtin_ctzll(position.pieces[WHITE_TURN ? WHITE_KING : BLACK_KING]);
+        return attackersTo(KING_LOC, position.occupied(), position) & (WHITE_TURN ? position.blackPieces : position.whitePieces);
+    }
+    
+    // every piece of either color attacking the square given which squares are occupied
+    Bitboard attackersTo(const int SQUARE, const Bitboard occupied, const Position& position) {
+        return (pawnAttacks(true, SQUARE) & position.pieces[BLACK_PAWN])
+            | (pawnAttacks(false, SQUARE) & position.pieces[WHITE_PAWN])
+            | (knightAttacks(SQUARE) & (position.pieces[WHITE_KNIGHT] | position.pieces[BLACK_KNIGHT]))
+            | (kingAttacks(SQUARE) & (position.pieces[WHITE_KING] | position.pieces[BLACK_KING]))
+            | (bishopAttacks(SQUARE, occupied) & (position.pieces[WHITE_BISHOP] | position.pieces[BLACK_BISHOP]
+                | position.pieces[WHITE_QUEEN] | position.pieces[BLACK_QUEEN]))
+            | (rookAttacks(SQUARE, occupied) & (position.pieces[WHITE_ROOK] | position.pieces[BLACK_ROOK]
+                | position.pieces[WHITE_QUEEN] | position.pieces[BLACK_QUEEN]));
+    }
+    
+    // static exchange evaluation, the material in hundredths of a pawn the side making MOVE wins if both sides keep
+    // recapturing on its end square with their cheapest piece and may stop whenever that is better.
+    // pins are ignored and castles count as winning nothing
+    int see(const Move MOVE, const Position& position) {
+        PROFILE_PHASE(ATTACKS);
+        if (moveFlag(MOVE) == CASTLE) {
+            return 0;
         }
-        
-        // add bishop attacks
-        while(bishops) {
-            pieceLocation = __builtin_ctzll(bishops);
-            smallestPiece = bishops & -bishops;
-            allThreats |= hypQuint(empty, smallestPiece, DIAGONAL_MASKS1[pieceLocation / 8 + pieceLocation % 8])
-                | hypQuint(empty, smallestPiece, DIAGONAL_MASKS2[pieceLocation / 8 + 7 - pieceLocation % 8]);
-            bishops ^= smallestPiece;
+        const int START = moveStart(MOVE);
+        const int END = moveEnd(MOVE);
+        const int PROMOTION_VALUE = isPromotion(MOVE) ? SEE_VALUES[moveFlag(MOVE) - PROMOTE_N + 1] - SEE_VALUES[0] : 0;
+        
+        // gains[i] is what the side taking at step i has won so far, if the exchange stopped there
+        int gains[32];
+        int steps = 0;
+        Bitboard occupied = position.occupied() ^ 1ULL << START;
+        if (moveFlag(MOVE) == EN_PASSANT) {
+            occupied ^= position.enPassant;
+            gains[0] = SEE_VALUES[0];
+        } else {
+            gains[0] = position.mailbox[END] == NO_PIECE ? 0 : SEE_VALUES[position.mailbox[END] % 6];
         }
-        
-        // add rook attacks
-        while(rooks) {
-            pieceLocation = __builtin_ctzll(rooks);
-            smallestPiece = rooks & -rooks;
-            allThreats |= hypQuint(empty, smallestPiece, FILE_MASKS[pieceLocation % 8])
-                    | hypQuint(empty, smallestPiece, RANK_MASKS[pieceLocation / 8]);
-            rooks ^= smallestPiece;
+        gains[0] += PROMOTION_VALUE;
+        
+        // the piece standing on the square, which the next capture takes
+        int onSquareValue = PROMOTION_VALUE ? SEE_VALUES[moveFlag(MOVE) - PROMOTE_N + 1] : SEE_VALUES[position.mailbox[START] % 6];
+        bool whiteTakes = !isWhitePiece(position.mailbox[START]);
+        const Bitboard DIAGONAL = position.pieces[WHITE_BISHOP] | position.pieces[BLACK_BISHOP]
+            | position.pieces[WHITE_QUEEN] | position.pieces[BLACK_QUEEN];
+        const Bitboard STRAIGHT = position.pieces[WHITE_ROOK] | position.pieces[BLACK_ROOK]
+            | position.pieces[WHITE_QUEEN] | position.pieces[BLACK_QUEEN];
+        Bitboard attackers = attackersTo(END, occupied, position) & occupied;
+        
+        while (steps < 31) {
+            // cheapest attacker of the side to take
+            const Bitboard OWN = attackers & (whiteTakes ? position.whitePieces : position.blackPieces);
+            if (!OWN) {
+                break;
+            }
+            int type = 0;
+            Bitboard from = 0;
+            for (; type < 6; ++type) {
+                from = OWN & position.pieces[(whiteTakes ? WHITE_PAWN : BLACK_PAWN) + type];
+                if (from) {
+                    break;
+                }
+            }
+            
+            // the king can only take last
+            if (type == 5 && (attackers & ~OWN)) {
+                break;
+            }
+            
+            ++steps;
+            gains[steps] = onSquareValue - gains[steps - 1];
+            onSquareValue = SEE_VALUES[type];
+            
+            // lifting the attacker can uncover a slider behind it
+            occupied ^= from & -from;
+            attackers |= (bishopAttacks(END, occupied) & DIAGONAL) | (rookAttacks(END, occupied) & STRAIGHT);
+            attackers &= occupied;
+            whiteTakes = !whiteTakes;
         }
         
-        // add queen attacks
-        while(queens) {
-            pieceLocation = __builtin_ctzll(queens);
-            smallestPiece = queens & -queens;
-            allThreats |= hypQuint(empty, smallestPiece, DIAGONAL_MASKS1[pieceLocation / 8 + pieceLocation % 8])
-                | hypQuint(empty, smallestPiece, DIAGONAL_MASKS2[pieceLocation / 8 + 7 - pieceLocation % 8])
-                | hypQuint(empty, smallestPiece, FILE_MASKS[pieceLocation % 8])
-                | hypQuint(empty, smallestPiece, RANK_MASKS[pieceLocation / 8]);
-            queens ^= smallestPiece;
+        // each side only takes when it doesn't lose by doing so
+        while (steps > 0) {
+            gains[steps - 1] = std::min(gains[steps - 1], -gains[steps]);
+            --steps;
         }
-        
-        // add king attacks
-        pieceLocation = __builtin_ctzll(king);
-        possibility = pieceLocation > 9 ? KING_SPAN << (pieceLocation - 9) 
-                                        : KING_SPAN >> (9 - pieceLocation);
-        possibility &= pieceLocation % 8 < 4 ? ~FILE_GH : ~FILE_AB;
-        allThreats |= possibility;
-        
-        return allThreats;
+        return gains[0];
     }
     
+    // squares a pawn of the chosen color on the square attacks
+    Bitboard pawnAttacks(const bool WHITE_PAWN_ATTACKS, const int SQUARE) {
+        const Bitboard PAWN = 1ULL << SQUARE;
+        return WHITE_PAWN_ATTACKS ? (PAWN >> 7 & ~FILE_A) | (PAWN >> 9 & ~FILE_H)
+                                  : (PAWN << 7 & ~FILE_H) | (PAWN << 9 & ~FILE_A);
+    }
+    
+    Bitboard knightAttacks(const int SQUARE) {
+        return LEAPER_ATTACKS.knight[SQUARE];
+    }
+    
+    Bitboard kingAttacks(const int SQUARE) {
+        return LEAPER_ATTACKS.king[SQUARE];
+    }
+    
+    Bitboard bishopAttacks(const int SQUARE, const Bitboard occupied) {
+        return SLIDER_ATTACKS.bishop(SQUARE, occupied);
+    }
+    
+    Bitboard rookAttacks(const int SQUARE, const Bitboard occupied) {
+        return SLIDER_ATTACKS.rook(SQUARE, occupied);
+    }
+
 };
 
 #endif
@@ -0,0 +1,245 @@
+/**
+ * Purpose: Score pawn structure and cache it by the pawn key since pawns rarely move during a search
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <memory>
+#include <bit>
+#ifndef PAWNS_H
+#define PAWNS_H
+#include <stdint.h>
+#include "board.h"
+#include "psqt.h"
+
+// pawn structure terms in hundredths of a pawn, passed pawns are indexed by ranks from their own side
+inline constexpr int PASSED_PAWN_VALUES[8] = { 0, 5, 10, 20, 35, 60, 100, 0 };
+inline constexpr int ISOLATED_PAWN_PENALTY = 15;
+inline constexpr int DOUBLED_PAWN_PENALTY = 10;
+inline constexpr int BACKWARD_PAWN_PENALTY = 8;
+
+// shield pawns one and two ranks in front of a king, counted in full with every piece on the board
+inline constexpr int SHIELD_CLOSE_VALUE = 12;
+inline constexpr int SHIELD_FAR_VALUE = 6;
+
+// kilobytes of pawn table each searching thread gets unless told otherwise
+inline constexpr size_t DEFAULT_PAWN_HASH_KB = 1024;
+
+// everything about one pawn structure that doesn't depend on the other pieces
+struct PawnEntry {
+    uint64_t key = 0;
+    int score = 0; // passed, isolated, doubled and backward pawns from white's side
+    
+    // shield for a king on the queen side, in the center or on the king side, indexed white then black
+    int shield[2][3] = {};
+};
+
+class PawnTable {
+private:
+    std::unique_ptr<PawnEntry[]> entries;
+    size_t mask = 0;
+    
+    // counted so the table can be sized, a hit rate near 100% means it is big enough
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    
+    static constexpr Bitboard FILE_A = 0x0101010101010101ULL;
+    static constexpr Bitboard FILE_H = FILE_A << 7;
+    
+    // files a to c, d and e, and f to h, a king on one of them is sheltered by the pawns in front of it
+    static constexpr Bitboard ZONE_FILES[3] = { FILE_A * 0x07, FILE_A * 0x18, FILE_A * 0xE0 };
+    
+    // white pawns move toward square 0, so north fills toward the eighth rank
+    static Bitboard northFill(Bitboard bitboard) {
+        bitboard |= bitboard >> 8;
+        bitboard |= bitboard >> 16;
+        return bitboard | bitboard >> 32;
+    }
+    
+    static Bitboard southFill(Bitboard bitboard) {
+        bitboard |= bitboard << 8;
+        bitboard |= bitboard << 16;
+        return bitboard | bitboard << 32;
+    }
+    
+    static Bitboard east(const Bitboard BITBOARD) {
+        return BITBOARD << 1 & ~FILE_A;
+    }
+    
+    static Bitboard west(const Bitboard BITBOARD) {
+        return BITBOARD >> 1 & ~FILE_H;
+    }
+    
+    // every square in front of the pawns, not counting their own squares
+    static Bitboard frontSpan(const Bitboard PAWNS, const bool WHITE) {
+        return WHITE ? northFill(PAWNS >> 8) : southFill(PAWNS << 8);
+    }
+    
+    // structure score of one side's pawns, positive is good for that side
+    static int structureScore(const Bitboard OWN, const Bitboard ENEMY, const bool WHITE) {
+        int score = 0;
+        
+        // passed, no enemy pawn ahead on the same or a next file and no own pawn ahead on the file
+        const Bitboard ENEMY_FRONT = frontSpan(ENEMY, !WHITE);
+        Bitboard passed = OWN & ~(ENEMY_FRONT | east(ENEMY_FRONT) | west(ENEMY_FRONT)) & ~frontSpan(OWN, !WHITE);
+        for (; passed; passed &= passed - 1) {
+            const int ROW = __builtin_ctzll(passed) / 8;
+            score += PASSED_PAWN_VALUES[WHITE ? 7 - ROW : ROW];
+        }
+        
+        score -= ISOLATED_PAWN_PENALTY * __builtin_popcountll(isolatedPawns(OWN));
+        
+        // doubled, every pawn with another of its own behind it
+        score -= DOUBLED_PAWN_PENALTY * __builtin_popcountll(OWN & frontSpan(OWN, WHITE));
+        
+        score -= BACKWARD_PAWN_PENALTY * __builtin_popcountll(backwardPawns(OWN, ENEMY, WHITE));
+        return score;
+    }
+    
+    // pawns with no own pawn on either next file
+    static Bitboard isolatedPawns(const Bitboard OWN) {
+        const Bitboard FILES = northFill(OWN) | southFill(OWN);
+        return OWN & ~(east(FILES) | west(FILES));
+    }
+    
+    // pawns whose square in front is taken by an enemy pawn while no pawn on a next file can come up
+    // to guard it, isolated pawns are already scored as isolated. a neighbour guards that square once
+    // it is level with the pawn, so one already past the pawn can't, which is why the fill is checked
+    // against the pawn's own square rather than the one in front
+    static Bitboard backwardPawns(const Bitboard OWN, const Bitboard ENEMY, const bool WHITE) {
+        const Bitboard SIDES = east(OWN) | west(OWN);
+        const Bitboard GUARDABLE = WHITE ? northFill(SIDES) : southFill(SIDES);
+        const Bitboard ENEMY_ATTACKS = WHITE ? (east(ENEMY) | west(ENEMY)) << 8 : (east(ENEMY) | west(ENEMY)) >> 8;
+        const Bitboard STOPS_ATTACKED = WHITE ? ENEMY_ATTACKS << 8 : ENEMY_ATTACKS >> 8;
+        return OWN & ~isolatedPawns(OWN) & STOPS_ATTACKED & ~GUARDABLE;
+    }
+    
+    // squares written like a3 c5, for printing suite results
+    static std::string squaresToString(Bitboard squares) {
+        std::string text;
+        for (; squares; squares &= squares - 1) {
+            const int SQUARE = __builtin_ctzll(squares);
+            text += (text.empty() ? "" : " ") + std::string{ char('a' + SQUARE % 8), char('8' - SQUARE / 8) };
+        }
+        return text.empty() ? "-" : text;
+    }
+    
+    struct BackwardPawnTest {
+        std::string name;
+        std::string fen;
+        std::string white; // backward white pawns, - for none
+        std::string black;
+    };
+    
+    // hand checked positions for the backward pawn rule, around where a neighbour can still guard
+    inline static const std::vector<BackwardPawnTest> SUITE = {
+        { "ahead", "4k3/8/8/8/4p3/2P5/3P4/4K3 w - - 0 1", "d2", "-" },
+        { "level", "4k3/8/8/8/4p3/8/2PP4/4K3 w - - 0 1", "-", "-" },
+        { "behind", "4k3/8/8/4p3/8/3P4/2P5/4K3 w - - 0 1", "-", "-" },
+        { "black ahead", "4k3/3p4/2p5/4P3/8/8/8/4K3 b - - 0 1", "-", "d7" },
+        { "sicilian", "4k3/8/3p4/4p3/4P3/8/8/4K3 b - - 0 1", "-", "d6" }
+    };
+    
+    static int shieldScore(const Bitboard OWN, const int ZONE, const bool WHITE) {
+        const Bitboard CLOSE_ROW = 0xFFULL << 8 * (WHITE ? 6 : 1);
+        const Bitboard FAR_ROW = 0xFFULL << 8 * (WHITE ? 5 : 2);
+        return SHIELD_CLOSE_VALUE * __builtin_popcountll(OWN & ZONE_FILES[ZONE] & CLOSE_ROW)
+            + SHIELD_FAR_VALUE * __builtin_popcountll(OWN & ZONE_FILES[ZONE] & FAR_ROW);
+    }
+    
+    static int zoneOf(const int SQUARE) {
+        const int FILE = SQUARE % 8;
+        return FILE <= 2 ? 0 : FILE <= 4 ? 1 : 2;
+    }
+    
+public:
+    PawnTable(const size_t SIZE_KB = DEFAULT_PAWN_HASH_KB) {
+        resize(SIZE_KB);
+    }
+    
+    // reallocate to the size in kilobytes rounded down to a power of two entries, this throws away every entry
+    void resize(const size_t SIZE_KB) {
+        const size_t FITS = std::max<size_t>(1, SIZE_KB * 1024 / sizeof(PawnEntry));
+        size_t count = 1;
+        while (count * 2 <= FITS) {
+            count *= 2;
+        }
+        entries.reset(new PawnEntry[count]);
+        mask = count - 1;
+        resetCounters();
+    }
+    
+    void resetCounters() {
+        probes = 0;
+        hits = 0;
+    }
+    
+    uint64_t getProbes() const {
+        return probes;
+    }
+    
+    uint64_t getHits() const {
+        return hits;
+    }
+    
+    // entry for the position's pawns, scored and stored first if it isn't cached. an empty entry
+    // already holds the right answer for a board without pawns
+    const PawnEntry& probe(const Position& position) {
+        ++probes;
+        PawnEntry& entry = entries[position.pawnKey & mask];
+        if (entry.key == position.pawnKey) {
+            ++hits;
+            return entry;
+        }
+        
+        const Bitboard WHITE_PAWNS = position.pieces[WHITE_PAWN];
+        const Bitboard BLACK_PAWNS = position.pieces[BLACK_PAWN];
+        entry.key = position.pawnKey;
+        entry.score = structureScore(WHITE_PAWNS, BLACK_PAWNS, true) - structureScore(BLACK_PAWNS, WHITE_PAWNS, false);
+        for (int zone = 0; zone < 3; ++zone) {
+            entry.shield[0][zone] = shieldScore(WHITE_PAWNS, zone, true);
+            entry.shield[1][zone] = shieldScore(BLACK_PAWNS, zone, false);
+        }
+        return entry;
+    }
+    
+    // pawn terms in hundredths of a pawn from white's side, the shield fades with the pieces since
+    // an endgame king wants to be active rather than sheltered
+    int score(const Position& position) {
+        const PawnEntry& ENTRY = probe(position);
+        const int SHIELD = ENTRY.shield[0][zoneOf(__builtin_ctzll(position.pieces[WHITE_KING]))]
+            - ENTRY.shield[1][zoneOf(__builtin_ctzll(position.pieces[BLACK_KING]))];
+        return ENTRY.score + SHIELD * std::min(position.phase, MAX_PHASE) / MAX_PHASE;
+    }
+    
+    // check the backward pawns of every suite position and print pass/fail, true if all pass
+    static bool runSuite() {
+        bool allPassed = true;
+        for (const BackwardPawnTest& TEST : SUITE) {
+            const Position POSITION = Board::fenToPosition(TEST.fen);
+            const Bitboard WHITE_PAWNS = POSITION.pieces[WHITE_PAWN];
+            const Bitboard BLACK_PAWNS = POSITION.pieces[BLACK_PAWN];
+            const std::string WHITE_FOUND = squaresToString(backwardPawns(WHITE_PAWNS, BLACK_PAWNS, true));
+            const std::string BLACK_FOUND = squaresToString(backwardPawns(BLACK_PAWNS, WHITE_PAWNS, false));
+            const bool PASSED = WHITE_FOUND == TEST.white && BLACK_FOUND == TEST.black;
+            allPassed &= PASSED;
+            
+            std::cout << (PASSED ? "PASS " : "FAIL ") << std::left << std::setw(12) << TEST.name
+                << " white " << WHITE_FOUND << ", black " << BLACK_FOUND;
+            if (!PASSED) {
+                std::cout << " (expected " << TEST.white << ", " << TEST.black << ")";
+            }
+            std::cout << "\n";
+        }
+        std::cout << (allPassed ? "All positions passed" : "Some positions failed") << std::endl;
+        return allPassed;
+    }
+};
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ * Purpose: Count move generator leaf nodes to check correctness and measure speed
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#ifndef PERFT_H
+#define PERFT_H
+#include <stdint.h>
+#include "board.h"
+#include "moves.h"
+
+class Perft {
+private:
+    struct perftPosition {
+        std::string name;
+        std::string fen;
+        std::vector<uint64_t> nodes; // known leaf counts starting at depth 1
+    };
+    
+    // reference counts from the chess programming wiki perft results and the chess960 perft list
+    const std::vector<perftPosition> SUITE = {
+        { "start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            { 20, 400, 8902, 197281, 4865609, 119060324 } },
+        { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+            { 48, 2039, 97862, 4085603, 193690690 } },
+        { "endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+            { 14, 191, 2812, 43238, 674624, 11030083 } },
+        { "promotions", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+            { 6, 264, 9467, 422333, 15833292 } },
+        { "talkchess", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+            { 44, 1486, 62379, 2103487, 89941194 } },
+        { "middlegame", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+            { 46, 2079, 89890, 3894594, 164075551 } },
+        { "chess960 1", "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9",
+            { 21, 528, 12189, 326672, 8146062 } },
+        { "chess960 2", "2nnrbkr/p1qppppp/8/1ppb4/6PP/3PP3/PPP2P2/BQNNRBKR w HEhe - 1 9",
+            { 21, 807, 18002, 667366, 16253601 } },
+        { "chess960 3", "b1q1rrkb/pppppppp/3nn3/8/P7/1PPP4/4PPPP/BQNNRKRB w GE - 1 9",
+            { 20, 479, 10471, 273318, 6417013 } },
+        { "chess960 4", "qbbnnrkr/2pp2pp/p7/1p2pp2/8/P3PP2/1PPP1KPP/QBBNNR1R w hf - 0 9",
+            { 22, 593, 13440, 382958, 9183776 } },
+        { "chess960 5", "1nbbnrkr/p1p1ppp1/3p4/1p3P1p/3Pq2P/8/PPP1P1P1/QNBBNRKR w HFhf - 0 9",
+            { 28, 1120, 31058, 1171749, 34030312 } },
+        { "chess960 6", "qnbnr1kr/ppp1b1pp/4p3/3p1p2/8/2NPP3/PPP1BPPP/QNB1R1KR w HEhe - 1 9",
+            { 29, 899, 26578, 824055, 24851983 } }
+    };
+    
+public:
+    // count every legal move sequence of length DEPTH from the position
+    uint64_t perft(const int DEPTH, Moves& moves1, Position& position) {
+        if (DEPTH == 0) {
+            return 1;
+        }
+        
+        MoveList moveList;
+        if (position.whiteTurn) {
+            moves1.possibleMovesWhite(moveList, position);
+        } else {
+            moves1.possibleMovesBlack(moveList, position);
+        }
+        
+        // every generated move is legal so the last ply only needs counting
+        if (DEPTH == 1) {
+            return moveList.size;
+        }
+        
+        uint64_t nodes = 0;
+        for (const Move MOVE : moveList) {
+            moves1.doMove(MOVE, position);
+            nodes += perft(DEPTH - 1, moves1, position);
+            moves1.undoMove(MOVE, position);
+        }
+        return nodes;
+    }
+    
+    // perft split by root move, so a wrong total can be traced to the move that causes it
+    std::vector<std::pair<Move, uint64_t>> divide(const int DEPTH, Moves& moves1, Position& position) {
+        std::vector<std::pair<Move, uint64_t>> results;
+        
+        MoveList moveList;
+        if (position.whiteTurn) {
+            moves1.possibleMovesWhite(moveList, position);
+        } else {
+            moves1.possibleMovesBlack(moveList, position);
+        }
+        
+        for (const Move MOVE : moveList) {
+            moves1.doMove(MOVE, position);
+            results.push_back({ MOVE, perft(DEPTH - 1, moves1, position) });
+            moves1.undoMove(MOVE, position);
+        }
+        return results;
+    }
+    
+    // run every suite position up to MAX_DEPTH and print nodes, speed and pass/fail, true if all pass
+    bool runSuite(const int MAX_DEPTH, Moves& moves1) {
+        bool allPassed = true;
+        uint64_t totalNodes = 0;
+        double totalSeconds = 0;
+        
+        for (const perftPosition& TEST : SUITE) {
+            const int DEPTH = std::min(MAX_DEPTH, static_cast<int>(TEST.nodes.size()));
+            Position position = Board::fenToPosition(TEST.fen);
+            
+            const auto START = std::chrono::steady_clock::now();
+            const uint64_t NODES = perft(DEPTH, moves1, position);
+            const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+            
+            const bool PASSED = NODES == TEST.nodes[DEPTH - 1];
+            allPassed &= PASSED;
+            totalNodes += NODES;
+            totalSeconds += SECONDS;
+            
+            std::cout << (PASSED ? "PASS " : "FAIL ") << std::left << std::setw(12) << TEST.name
+                << " depth " << DEPTH << ": " << NODES << " nodes";
+            if (!PASSED) {
+                std::cout << " (expected " << TEST.nodes[DEPTH - 1] << ")";
+            }
+            std::cout << ", " << static_cast<uint64_t>(NODES / std::max(SECONDS, 1e-9)) << " nps\n";
+        }
+        
+        std::cout << (allPassed ? "All positions passed" : "Some positions failed")
+            << ", " << totalNodes << " nodes, "
+            << static_cast<uint64_t>(totalNodes / std::max(totalSeconds, 1e-9)) << " nps" << std::endl;
+        return allPassed;
+    }
+};
+
+#endif
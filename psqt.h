@@ -0,0 +1,226 @@
+/**
+ * Purpose: Piece values and piece location tables the position keeps its scores with
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#ifndef PSQT_H
+#define PSQT_H
+#include <stdint.h>
+
+// material of each piece in hundredths of a pawn from white's side, indexed by Piece
+inline constexpr int PIECE_VALUES[12] = { 100, 300, 300, 500, 900, 0, -100, -300, -300, -500, -900, 0 };
+
+// how much each piece counts toward the middlegame, the start position adds up to MAX_PHASE
+inline constexpr int PHASE_WEIGHTS[12] = { 0, 1, 1, 2, 4, 0, 0, 1, 1, 2, 4, 0 };
+inline constexpr int MAX_PHASE = 24;
+
+// location values in hundredths of a pawn for each piece type, pawn to king, as white sees the
+// board with the eighth rank first. the middlegame and endgame tables are blended by phase
+struct PieceSquareTables {
+    int middlegame[6][64];
+    int endgame[6][64];
+};
+
+inline constexpr PieceSquareTables DEFAULT_PIECE_SQUARE_TABLES = {
+    {
+        {
+              0,   0,   0,   0,   0,   0,   0,   0,
+             50,  50,  50,  50,  50,  50,  50,  50,
+             10,  10,  20,  30,  30,  20,  10,  10,
+              5,   5,  10,  25,  25,  10,   5,   5,
+              0,   0,   0,  20,  20,   0,   0,   0,
+              5,  -5, -10,   0,   0, -10,  -5,   5,
+              5,  10,  10, -20, -20,  10,  10,   5,
+              0,   0,   0,   0,   0,   0,   0,   0
+        }, {
+            -50, -40, -30, -30, -30, -30, -40, -50,
+            -40, -20,   0,   0,   0,   0, -20, -40,
+            -30,   0,  10,  15,  15,  10,   0, -30,
+            -30,   5,  15,  20,  20,  15,   5, -30,
+            -30,   0,  15,  20,  20,  15,   0, -30,
+            -30,   5,  10,  15,  15,  10,   5, -30,
+            -40, -20,   0,   5,   5,   0, -20, -40,
+            -50, -40, -30, -30, -30, -30, -40, -50
+        }, {
+            -20, -10, -10, -10, -10, -10, -10, -20,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -10,   0,   5,  10,  10,   5,   0, -10,
+            -10,   5,   5,  10,  10,   5,   5, -10,
+            -10,   0,  10,  10,  10,  10,   0, -10,
+            -10,  10,  10,  10,  10,  10,  10, -10,
+            -10,   5,   0,   0,   0,   0,   5, -10,
+            -20, -10, -10, -10, -10, -10, -10, -20
+        }, {
+              0,   0,   0,   0,   0,   0,   0,   0,
+              5,  10,  10,  10,  10,  10,  10,   5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+             -5,   0,   0,   0,   0,   0,   0,  -5,
+              0,   0,   0,   5,   5,   0,   0,   0
+        }, {
+            -20, -10, -10,  -5,  -5, -10, -10, -20,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -10,   0,   5,   5,   5,   5,   0, -10,
+             -5,   0,   5,   5,   5,   5,   0,  -5,
+              0,   0,   5,   5,   5,   5,   0,  -5,
+            -10,   5,   5,   5,   5,   5,   0, -10,
+            -10,   0,   5,   0,   0,   0,   0, -10,
+            -20, -10, -10,  -5,  -5, -10, -10, -20
+        }, {
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -30, -40, -40, -50, -50, -40, -40, -30,
+            -20, -30, -30, -40, -40, -30, -30, -20,
+            -10, -20, -20, -20, -20, -20, -20, -10,
+             20,  20,   0,   0,   0,   0,  20,  20,
+             20,  30,  10,   0,   0,  10,  30,  20
+        }
+    }, {
+        {
+              0,   0,   0,   0,   0,   0,   0,   0,
+             60,  60,  60,  60,  60,  60,  60,  60,
+             40,  40,  40,  40,  40,  40,  40,  40,
+             25,  25,  25,  25,  25,  25,  25,  25,
+             12,  12,  12,  12,  12,  12,  12,  12,
+              5,   5,   5,   5,   5,   5,   5,   5,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0
+        }, {
+            -50, -40, -30, -30, -30, -30, -40, -50,
+            -40, -20,   0,   0,   0,   0, -20, -40,
+            -30,   0,  10,  15,  15,  10,   0, -30,
+            -30,   5,  15,  20,  20,  15,   5, -30,
+            -30,   0,  15,  20,  20,  15,   0, -30,
+            -30,   5,  10,  15,  15,  10,   5, -30,
+            -40, -20,   0,   5,   5,   0, -20, -40,
+            -50, -40, -30, -30, -30, -30, -40, -50
+        }, {
+            -20, -10, -10, -10, -10, -10, -10, -20,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -10,   0,   5,  10,  10,   5,   0, -10,
+            -10,   5,   5,  10,  10,   5,   5, -10,
+            -10,   0,  10,  10,  10,  10,   0, -10,
+            -10,  10,  10,  10,  10,  10,  10, -10,
+            -10,   5,   0,   0,   0,   0,   5, -10,
+            -20, -10, -10, -10, -10, -10, -10, -20
+        }, {
+              0,   0,   0,   0,   0,   0,   0,   0,
+             10,  10,  10,  10,  10,  10,  10,  10,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0,
+              0,   0,   0,   0,   0,   0,   0,   0
+        }, {
+            -20, -10, -10,  -5,  -5, -10, -10, -20,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -10,   0,   5,   5,   5,   5,   0, -10,
+             -5,   0,   5,   5,   5,   5,   0,  -5,
+             -5,   0,   5,   5,   5,   5,   0,  -5,
+            -10,   0,   5,   5,   5,   5,   0, -10,
+            -10,   0,   0,   0,   0,   0,   0, -10,
+            -20, -10, -10,  -5,  -5, -10, -10, -20
+        }, {
+            -50, -40, -30, -20, -20, -30, -40, -50,
+            -30, -20, -10,   0,   0, -10, -20, -30,
+            -30, -10,  20,  30,  30,  20, -10, -30,
+            -30, -10,  30,  40,  40,  30, -10, -30,
+            -30, -10,  30,  40,  40,  30, -10, -30,
+            -30, -10,  20,  30,  30,  20, -10, -30,
+            -30, -30,   0,   0,   0,   0, -30, -30,
+            -50, -30, -30, -30, -30, -30, -30, -50
+        }
+    }
+};
+
+// location value of every piece on every square from white's side, flattened to piece * 64 + square
+// so a move changes the score by a few single lookups
+struct PlacementTable {
+    int middlegame[12 * 64];
+    int endgame[12 * 64];
+};
+
+// square 0 is a8 so the written tables already match the board for white, black pieces use the
+// square with its rank flipped and count against white
+constexpr PlacementTable makePlacementTable(const PieceSquareTables& TABLES) {
+    PlacementTable table = {};
+    for (int piece = 0; piece < 12; ++piece) {
+        const bool WHITE = piece < 6;
+        for (int square = 0; square < 64; ++square) {
+            const int FROM = WHITE ? square : square ^ 56;
+            table.middlegame[piece * 64 + square] = WHITE ? TABLES.middlegame[piece % 6][FROM] : -TABLES.middlegame[piece % 6][FROM];
+            table.endgame[piece * 64 + square] = WHITE ? TABLES.endgame[piece % 6][FROM] : -TABLES.endgame[piece % 6][FROM];
+        }
+    }
+    return table;
+}
+
+// built from the defaults at compile time, loadPieceSquareTables can replace it at startup before
+// any position is set up
+inline PlacementTable PLACEMENT = makePlacementTable(DEFAULT_PIECE_SQUARE_TABLES);
+
+// write the tables in use in the format loadPieceSquareTables reads, a starting point for tuning
+inline void writePieceSquareTables(std::ostream& out) {
+    const char* NAMES[6] = { "pawn", "knight", "bishop", "rook", "queen", "king" };
+    out << "# location values in hundredths of a pawn from white's side, eighth rank first\n";
+    for (int stage = 0; stage < 2; ++stage) {
+        for (int type = 0; type < 6; ++type) {
+            out << "# " << (stage == 0 ? "middlegame " : "endgame ") << NAMES[type] << "\n";
+            for (int square = 0; square < 64; ++square) {
+                const int VALUE = stage == 0 ? PLACEMENT.middlegame[type * 64 + square] : PLACEMENT.endgame[type * 64 + square];
+                out << VALUE << (square % 8 == 7 ? "\n" : " ");
+            }
+        }
+    }
+}
+
+// read 768 whole numbers, the six middlegame tables then the six endgame tables laid out like
+// writePieceSquareTables, # starts a comment. false and nothing changed if the file doesn't fit
+inline bool loadPieceSquareTables(const std::string& PATH) {
+    std::ifstream file(PATH);
+    if (!file) {
+        return false;
+    }
+    
+    PieceSquareTables tables = {};
+    int count = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream values(line.substr(0, line.find('#')));
+        std::string token;
+        while (values >> token) {
+            if (count == 768) {
+                return false;
+            }
+            try {
+                size_t used = 0;
+                const int VALUE = std::stoi(token, &used);
+                if (used != token.size()) {
+                    return false;
+                }
+                (count < 384 ? tables.middlegame : tables.endgame)[count % 384 / 64][count % 64] = VALUE;
+            } catch (const std::exception&) {
+                return false;
+            }
+            ++count;
+        }
+    }
+    if (count != 768) {
+        return false;
+    }
+    PLACEMENT = makePlacementTable(tables);
+    return true;
+}
+
+#endif
@@ -0,0 +1,259 @@
+/**
+ * Purpose: Run the search on several threads at once that share one transposition table
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#ifndef SMP_H
+#define SMP_H
+#include <stdint.h>
+#include "board.h"
+#include "moves.h"
+#include "evaluate.h"
+#include "transposition.h"
+
+// lazy smp, every thread searches the whole tree from its own copy of the position and they
+// speed each other up through the entries they leave in the shared transposition table
+class ParallelSearch {
+private:
+    // everything a thread changes while searching, nothing here is shared
+    struct Worker {
+        Position position;
+        Moves moves1;
+        Evaluate evaluate1;
+        
+        Worker(TranspositionTable& table) : evaluate1(table) {}
+    };
+    
+    TranspositionTable& table;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> stopSignal = false;
+    SearchOptions options;
+    std::function<void(const SearchReport&)> reporter;
+    
+    Move bestMove = NULL_MOVE;
+    Score bestScore = 0;
+    int completedDepth = 0;
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0;
+    uint64_t pawnProbes = 0;
+    uint64_t pawnHits = 0;
+    SearchStats stats;
+    
+public:
+    ParallelSearch(TranspositionTable& table, const int THREADS) : table(table) {
+        setThreads(THREADS);
+    }
+    
+    void setThreads(const int THREADS) {
+        workers.clear();
+        for (int i = 0; i < std::max(1, THREADS); ++i) {
+            workers.push_back(std::make_unique<Worker>(table));
+            workers.back()->evaluate1.shareStopSignal(stopSignal);
+            workers.back()->evaluate1.setOptions(options);
+        }
+        setReporter(reporter);
+    }
+    
+    void setOptions(const SearchOptions& OPTIONS) {
+        options = OPTIONS;
+        for (std::unique_ptr<Worker>& worker : workers) {
+            worker->evaluate1.setOptions(options);
+        }
+    }
+    
+    // reports come from thread 0 on its own thread, with the nodes of every thread added up
+    void setReporter(const std::function<void(const SearchReport&)>& REPORTER) {
+        reporter = REPORTER;
+        if (!reporter) {
+            workers[0]->evaluate1.setReporter(nullptr);
+            return;
+        }
+        workers[0]->evaluate1.setReporter([this](const SearchReport& REPORT) {
+            SearchReport total = REPORT;
+            total.nodes = 0;
+            for (const std::unique_ptr<Worker>& WORKER : workers) {
+                total.nodes += WORKER->evaluate1.getPublishedNodes();
+            }
+            reporter(total);
+        });
+    }
+    
+    int getThreads() {
+        return workers.size();
+    }
+    
+    // thread 0 follows the limits and stops the helpers when it finishes, helpers only follow the
+    // depth limit. the node limit counts thread 0's nodes alone. CLEAR_STOP false keeps a stop that
+    // came in before the search started, for callers that clear it with clearStop and then hand the
+    // search to another thread
+    Move search(const SearchLimits& LIMITS, const Position& POSITION, const bool CLEAR_STOP = true) {
+        if (CLEAR_STOP) {
+            clearStop();
+        }
+        const auto START = std::chrono::steady_clock::now();
+        table.newSearch();
+        
+        SearchLimits helperLimits;
+        helperLimits.depth = LIMITS.depth;
+        
+        for (std::unique_ptr<Worker>& worker : workers) {
+            worker->evaluate1.clearPublishedNodes();
+        }
+        
+        std::vector<std::thread> helpers;
+        for (size_t i = 1; i < workers.size(); ++i) {
+            helpers.emplace_back([this, i, &helperLimits, &POSITION] {
+                Worker& worker = *workers[i];
+                worker.position = POSITION;
+                
+                // odd helpers start a ply deeper so threads spread over different depths
+                worker.evaluate1.search(helperLimits, worker.moves1, worker.position, 1 + i % 2);
+            });
+        }
+        
+        Worker& main = *workers[0];
+        main.position = POSITION;
+        main.evaluate1.search(LIMITS, main.moves1, main.position);
+        stopSignal = true;
+        for (std::thread& helper : helpers) {
+            helper.join();
+        }
+        
+        // take the deepest finished search, then the best score for the side to move, then the lowest
+        // thread, so the choice only depends on what the threads found and not on when they stopped
+        const Score SIGN = POSITION.whiteTurn ? 1 : -1;
+        Evaluate* chosen = &main.evaluate1;
+        nodes = 0;
+        qnodes = 0;
+        pawnProbes = 0;
+        pawnHits = 0;
+        stats = main.evaluate1.getStats();
+        for (const std::unique_ptr<Worker>& WORKER : workers) {
+            Evaluate& result = WORKER->evaluate1;
+            if (&result != &main.evaluate1) {
+                stats.add(result.getStats());
+            }
+            nodes += result.getNodes() + result.getQNodes();
+            qnodes += result.getQNodes();
+            pawnProbes += result.getPawnTable().getProbes();
+            pawnHits += result.getPawnTable().getHits();
+            if (result.getBestMove() == NULL_MOVE) {
+                continue;
+            }
+            if (result.getCompletedDepth() > chosen->getCompletedDepth()
+                    || (result.getCompletedDepth() == chosen->getCompletedDepth()
+                        && SIGN * result.getBestScore() > SIGN * chosen->getBestScore())) {
+                chosen = &result;
+            }
+        }
+        
+        bestMove = chosen->getBestMove();
+        bestScore = chosen->getBestScore();
+        completedDepth = chosen->getCompletedDepth();
+        if (options.statsLog) {
+            const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+            *options.statsLog << stats.toJson(workers.size(), completedDepth, bestScore, moveToAlgebraic(bestMove, options.chess960), SECONDS) << std::endl;
+        }
+        return bestMove;
+    }
+    
+    // safe to call from any thread while search is running
+    void stop() {
+        stopSignal = true;
+    }
+    
+    void clearStop() {
+        stopSignal = false;
+    }
+    
+    Move getBestMove() {
+        return bestMove;
+    }
+    
+    Score getBestScore() {
+        return bestScore;
+    }
+    
+    int getCompletedDepth() {
+        return completedDepth;
+    }
+    
+    // nodes of every thread added together, quiescence nodes included
+    uint64_t getNodes() {
+        return nodes;
+    }
+    
+    uint64_t getQNodes() {
+        return qnodes;
+    }
+    
+    // counters of every thread added up, iterations are thread 0's
+    const SearchStats& getStats() {
+        return stats;
+    }
+    
+    // pawn table lookups of every thread in the last search and how many found their entry
+    uint64_t getPawnProbes() {
+        return pawnProbes;
+    }
+    
+    uint64_t getPawnHits() {
+        return pawnHits;
+    }
+    
+    // time to reach DEPTH on a few positions with 1, 2, 4... up to MAX_THREADS threads, the table
+    // is cleared before each position so every run starts the same way
+    void benchmark(const int DEPTH, const int MAX_THREADS) {
+        const std::vector<std::string> FENS = {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+            "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+            "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+            "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"
+        };
+        SearchLimits limits;
+        limits.depth = DEPTH;
+        
+        double singleThreadSeconds = 0;
+        for (int threads = 1; threads <= MAX_THREADS; threads = threads == MAX_THREADS ? threads + 1 : std::min(threads * 2, MAX_THREADS)) {
+            setThreads(threads);
+            uint64_t totalNodes = 0;
+            uint64_t totalQNodes = 0;
+            uint64_t totalPawnProbes = 0;
+            uint64_t totalPawnHits = 0;
+            double seconds = 0;
+            for (const std::string& FEN : FENS) {
+                table.clear();
+                const auto START = std::chrono::steady_clock::now();
+                search(limits, Board::fenToPosition(FEN));
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+                totalNodes += nodes;
+                totalQNodes += qnodes;
+                totalPawnProbes += pawnProbes;
+                totalPawnHits += pawnHits;
+            }
+            if (threads == 1) {
+                singleThreadSeconds = seconds;
+            }
+            
+            std::cout << std::left << std::setw(3) << threads << " threads: " << std::fixed << std::setprecision(3)
+                << seconds << "s, " << totalNodes << " nodes (" << 100 * totalQNodes / std::max<uint64_t>(totalNodes, 1)
+                << "% quiescence), " << static_cast<uint64_t>(totalNodes / std::max(seconds, 1e-9))
+                << " nps, speedup " << std::setprecision(2) << singleThreadSeconds / std::max(seconds, 1e-9)
+                << ", pawn hits " << std::setprecision(1) << 100.0 * totalPawnHits / std::max<uint64_t>(totalPawnProbes, 1) << "%" << std::endl;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * Purpose: Count what the search does and, when built with -DSEARCH_PROFILE, time where it spends its time
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#ifndef STATS_H
+#define STATS_H
+#include <stdint.h>
+#if defined(SEARCH_PROFILE) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#endif
+
+// parts of the search timed by a profiling build. the timed functions don't call each other, so
+// the phases never count the same time twice
+enum SearchPhase { MOVE_GENERATION, MAKE_MOVE, ATTACKS, EVALUATION, PHASE_COUNT };
+
+inline constexpr const char* PHASE_NAMES[PHASE_COUNT] = { "moveGeneration", "makeMove", "attacks", "evaluation" };
+
+struct PhaseTimes {
+    uint64_t ticks[PHASE_COUNT] = {};
+    uint64_t calls[PHASE_COUNT] = {};
+    
+    void add(const PhaseTimes& OTHER) {
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            ticks[phase] += OTHER.ticks[phase];
+            calls[phase] += OTHER.calls[phase];
+        }
+    }
+};
+
+#ifdef SEARCH_PROFILE
+// each thread adds to its own times so the timers need no locks, a search copies them out when it ends
+inline thread_local PhaseTimes PHASE_TIMES;
+
+// cycles from the time stamp counter where there is one, nanoseconds otherwise
+inline uint64_t readTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline constexpr const char* TICK_UNIT =
+#if defined(__x86_64__) || defined(__i386__)
+    "cycles";
+#else
+    "nanoseconds";
+#endif
+
+// adds the time from its construction to the end of the scope to PHASE
+class PhaseTimer {
+private:
+    const SearchPhase phase;
+    const uint64_t start;
+    
+public:
+    PhaseTimer(const SearchPhase PHASE) : phase(PHASE), start(readTicks()) {}
+    
+    ~PhaseTimer() {
+        PHASE_TIMES.ticks[phase] += readTicks() - start;
+        ++PHASE_TIMES.calls[phase];
+    }
+};
+
+#define PROFILE_PHASE(PHASE) PhaseTimer phaseTimer(PHASE)
+#else
+#define PROFILE_PHASE(PHASE)
+#endif
+
+// counters for one search, cheap enough to always keep. beta cutoffs are counted in the main
+// search only, quiescence fails high on the static score too often for the rate to mean much
+struct SearchStats {
+    uint64_t nodes = 0;
+    uint64_t qnodes = 0;
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+    uint64_t ttCutoffs = 0;
+    uint64_t betaCutoffs = 0;
+    uint64_t firstMoveCutoffs = 0; // cutoffs by the first move searched, a measure of move ordering
+    
+    // nodes of each finished iteration alone, index 0 is the first depth searched
+    std::vector<uint64_t> iterationNodes;
+    int firstDepth = 1;
+    
+    PhaseTimes phases;
+    
+    // add the counters of a thread that searched alongside, iterations stay those of this one
+    // since threads start at different depths
+    void add(const SearchStats& OTHER) {
+        nodes += OTHER.nodes;
+        qnodes += OTHER.qnodes;
+        ttProbes += OTHER.ttProbes;
+        ttHits += OTHER.ttHits;
+        ttCutoffs += OTHER.ttCutoffs;
+        betaCutoffs += OTHER.betaCutoffs;
+        firstMoveCutoffs += OTHER.firstMoveCutoffs;
+        phases.add(OTHER.phases);
+    }
+    
+    // one line of JSON, the score is from white's side. the effective branching factor of an iteration is its nodes over the nodes
+    // of the one before, the first has none. phases only appear in a profiling build
+    std::string toJson(const int THREADS, const int DEPTH, const int SCORE, const std::string& BEST_MOVE,
+        const double SECONDS) const {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(3);
+        json << "{\"threads\":" << THREADS << ",\"depth\":" << DEPTH << ",\"score\":" << SCORE
+            << ",\"bestMove\":\"" << BEST_MOVE << "\",\"seconds\":" << SECONDS
+            << ",\"nodes\":" << nodes << ",\"qnodes\":" << qnodes
+            << ",\"nps\":" << static_cast<uint64_t>(nodes / std::max(SECONDS, 1e-9))
+            << ",\"tt\":{\"probes\":" << ttProbes << ",\"hits\":" << ttHits << ",\"cutoffs\":" << ttCutoffs << "}"
+            << ",\"betaCutoffs\":" << betaCutoffs << ",\"firstMoveCutoffRate\":"
+            << (betaCutoffs ? static_cast<double>(firstMoveCutoffs) / betaCutoffs : 0.0) << ",\"iterations\":[";
+        for (size_t i = 0; i < iterationNodes.size(); ++i) {
+            json << (i ? "," : "") << "{\"depth\":" << firstDepth + static_cast<int>(i) << ",\"nodes\":" << iterationNodes[i];
+            if (i > 0) {
+                json << ",\"ebf\":" << static_cast<double>(iterationNodes[i]) / std::max<uint64_t>(iterationNodes[i - 1], 1);
+            }
+            json << "}";
+        }
+        json << "]";
+#ifdef SEARCH_PROFILE
+        json << ",\"phases\":{\"unit\":\"" << TICK_UNIT << "\"";
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            json << ",\"" << PHASE_NAMES[phase] << "\":{\"calls\":" << phases.calls[phase]
+                << ",\"ticks\":" << phases.ticks[phase] << "}";
+        }
+        json << "}";
+#endif
+        json << "}";
+        return json.str();
+    }
+};
+
+#endif
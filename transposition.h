@@ -0,0 +1,159 @@
+/**
+ * Purpose: Remember searched positions so transpositions don't need to be searched again
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <atomic>
+#include <memory>
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+#include <stdint.h>
+#include "moves.h"
+
+// what the stored score means relative to the real score
+enum Bound : uint8_t { NO_BOUND, UPPER_BOUND, LOWER_BOUND, EXACT_BOUND };
+
+// unpacked copy of an entry
+struct TTData {
+    Move move;
+    int depth;
+    Score score; // mates count plies from this position, see scoreToTable
+    Bound bound;
+    int age;
+};
+
+// entries are two words, the data and the key xor the data. threads read and write them
+// without locks, a write torn by another thread leaves a key that no longer matches
+struct TTEntry {
+    std::atomic<uint64_t> keyXorData;
+    std::atomic<uint64_t> data;
+    
+    // data is packed as move (16 bits), score (16), depth (8), bound (2) and age (6), leaving the
+    // top 16 bits free
+    static uint64_t pack(const Move MOVE, const int DEPTH, const Score SCORE, const Bound BOUND, const int AGE) {
+        return MOVE
+            | static_cast<uint64_t>(static_cast<uint16_t>(SCORE)) << 16
+            | static_cast<uint64_t>(static_cast<uint8_t>(DEPTH)) << 32
+            | static_cast<uint64_t>(BOUND) << 40
+            | static_cast<uint64_t>(AGE) << 42;
+    }
+    
+    static TTData unpack(const uint64_t DATA) {
+        return { static_cast<Move>(DATA), static_cast<int8_t>(DATA >> 32),
+            static_cast<int16_t>(DATA >> 16), Bound(DATA >> 40 & 3), static_cast<int>(DATA >> 42 & 63) };
+    }
+};
+
+// four entries fill one 64 byte cache line so a probe touches a single line
+struct alignas(64) TTBucket {
+    TTEntry entries[4];
+};
+
+static_assert(sizeof(TTBucket) == 64, "bucket must fill exactly one cache line");
+
+class TranspositionTable {
+private:
+    std::unique_ptr<TTBucket[]> buckets;
+    size_t bucketCount = 0;
+    uint8_t age = 0;
+    
+    TTBucket& bucketFor(const uint64_t KEY) {
+        // multiply high maps the key onto any table size without needing a power of two
+        return buckets[static_cast<uint64_t>((static_cast<unsigned __int128>(KEY) * bucketCount) >> 64)];
+    }
+    
+public:
+    TranspositionTable(const size_t SIZE_MB) {
+        resize(SIZE_MB);
+    }
+    
+    // reallocate to the size in megabytes, this throws away every entry
+    void resize(const size_t SIZE_MB) {
+        bucketCount = std::max<size_t>(1, SIZE_MB * 1024 * 1024 / sizeof(TTBucket));
+        buckets.reset(new TTBucket[bucketCount]);
+        clear();
+    }
+    
+    void clear() {
+        for (size_t i = 0; i < bucketCount; ++i) {
+            for (TTEntry& entry : buckets[i].entries) {
+                entry.keyXorData.store(0, std::memory_order_relaxed);
+                entry.data.store(0, std::memory_order_relaxed);
+            }
+        }
+        age = 0;
+    }
+    
+    // called once per search so entries from old searches get replaced first
+    void newSearch() {
+        age = (age + 1) & 63;
+    }
+    
+    // entries written by the current search per thousand, counted over the first few buckets
+    int hashfull() const {
+        const size_t SAMPLE = std::min<size_t>(bucketCount, 250);
+        int used = 0;
+        for (size_t i = 0; i < SAMPLE; ++i) {
+            for (const TTEntry& ENTRY : buckets[i].entries) {
+                const TTData DATA = TTEntry::unpack(ENTRY.data.load(std::memory_order_relaxed));
+                used += DATA.bound != NO_BOUND && DATA.age == age;
+            }
+        }
+        return used * 1000 / static_cast<int>(SAMPLE * 4);
+    }
+    
+    size_t sizeMB() const {
+        return bucketCount * sizeof(TTBucket) / (1024 * 1024);
+    }
+    
+    // copy the entry for key into found, false if the position isn't stored
+    bool probe(const uint64_t KEY, TTData& found) {
+        TTBucket& bucket = bucketFor(KEY);
+        for (TTEntry& entry : bucket.entries) {
+            const uint64_t DATA = entry.data.load(std::memory_order_relaxed);
+            if ((entry.keyXorData.load(std::memory_order_relaxed) ^ DATA) == KEY && DATA) {
+                found = TTEntry::unpack(DATA);
+                return found.bound != NO_BOUND;
+            }
+        }
+        return false;
+    }
+    
+    // overwrite the entry with the same key, otherwise the shallowest and oldest entry in the bucket
+    void store(const uint64_t KEY, Move move, const int DEPTH, const Score SCORE, const Bound BOUND) {
+        TTBucket& bucket = bucketFor(KEY);
+        TTEntry* replace = &bucket.entries[0];
+        int replaceValue = 1 << 30;
+        bool sameKey = false;
+        for (TTEntry& entry : bucket.entries) {
+            const uint64_t DATA = entry.data.load(std::memory_order_relaxed);
+            const TTData OLD = TTEntry::unpack(DATA);
+            if ((entry.keyXorData.load(std::memory_order_relaxed) ^ DATA) == KEY || OLD.bound == NO_BOUND) {
+                replace = &entry;
+                sameKey = OLD.bound != NO_BOUND;
+                
+                // keep the old best move if this search didn't find one
+                if (move == NULL_MOVE && sameKey) {
+                    move = OLD.move;
+                }
+                break;
+            }
+            
+            // every search of age counts as much as 8 plies of depth
+            const int VALUE = OLD.depth - 8 * ((64 + age - OLD.age) & 63);
+            if (VALUE < replaceValue) {
+                replace = &entry;
+                replaceValue = VALUE;
+            }
+        }
+        
+        const uint64_t DATA = TTEntry::pack(move, DEPTH, SCORE, BOUND, age);
+        replace->keyXorData.store(KEY ^ DATA, std::memory_order_relaxed);
+        replace->data.store(DATA, std::memory_order_relaxed);
+    }
+};
+
+#endif
@@ -0,0 +1,308 @@
+/**
+ * Purpose: Talk the UCI protocol on standard input and output so GUIs and match runners can drive the engine
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <charconv>
+#ifndef UCI_H
+#define UCI_H
+#include <stdint.h>
+#include "board.h"
+#include "moves.h"
+#include "evaluate.h"
+#include "transposition.h"
+#include "smp.h"
+#include "book.h"
+
+inline const std::string START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+class Uci {
+private:
+    TranspositionTable& table;
+    ParallelSearch search1;
+    SearchOptions options;
+    Moves moves1;
+    Position position;
+    
+    // book moves are played without searching, the book only knows standard chess
+    PolyglotBook& book;
+    bool ownBook = true;
+    bool bestBookMove = false;
+    
+    // the search runs on its own thread so stop and isready are answered while it thinks
+    std::thread searchThread;
+    
+    // after go infinite bestmove waits for stop, even if the search ran out of depth first
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool stopRequested = false;
+    
+    // info lines come from the search thread, everything else from the reading thread
+    std::mutex outputMutex;
+    
+    // with only a clock the time left is spread over this many moves, plus most of the increment
+    static constexpr int64_t DEFAULT_MOVES_TO_GO = 30;
+    static constexpr int64_t MOVE_OVERHEAD = 50; // milliseconds kept back for the GUI
+    
+    void send(const std::string& LINE) {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << LINE << std::endl;
+    }
+    
+    // centipawns, or moves to mate with a minus when the side to move is getting mated
+    static std::string scoreToUci(const Score SCORE) {
+        if (std::abs(SCORE) >= MATE_BOUND) {
+            const int MOVES = (MATE_SCORE - std::abs(SCORE) + 1) / 2;
+            return "mate " + std::to_string(SCORE < 0 ? -MOVES : MOVES);
+        }
+        return "cp " + std::to_string(SCORE);
+    }
+    
+    void sendReport(const SearchReport& REPORT) {
+        std::ostringstream line;
+        line << "info depth " << REPORT.depth;
+        if (REPORT.finished) {
+            line << " score " << scoreToUci(REPORT.score);
+        }
+        line << " nodes " << REPORT.nodes << " nps " << REPORT.nodes * 1000 / std::max<int64_t>(REPORT.milliseconds, 1)
+            << " hashfull " << table.hashfull() << " time " << REPORT.milliseconds;
+        if (REPORT.finished && !REPORT.principalVariation.empty()) {
+            line << " pv";
+            for (const Move MOVE : REPORT.principalVariation) {
+                line << " " << moveToAlgebraic(MOVE, options.chess960);
+            }
+        }
+        send(line.str());
+    }
+    
+    // the legal move written as TEXT, NULL_MOVE if there is none
+    Move parseMove(const std::string& TEXT) {
+        MoveList moveList;
+        if (position.whiteTurn) {
+            moves1.possibleMovesWhite(moveList, position);
+        } else {
+            moves1.possibleMovesBlack(moveList, position);
+        }
+        for (const Move MOVE : moveList) {
+            if (moveToAlgebraic(MOVE, options.chess960) == TEXT) {
+                return MOVE;
+            }
+        }
+        return NULL_MOVE;
+    }
+    
+    // position startpos|fen <fen> [moves <move>...], the moves are played so repetitions of
+    // positions before the search are still seen
+    void setPosition(std::istringstream& arguments) {
+        std::string token;
+        std::string fen;
+        arguments >> token;
+        if (token == "startpos") {
+            fen = START_FEN;
+            arguments >> token;
+        } else if (token == "fen") {
+            while (arguments >> token && token != "moves") {
+                fen += token + " ";
+            }
+        } else {
+            return;
+        }
+        
+        position = Board::fenToPosition(fen);
+        while (token == "moves" && arguments >> token) {
+            const Move MOVE = parseMove(token);
+            if (MOVE == NULL_MOVE) {
+                break;
+            }
+            moves1.doMove(MOVE, position);
+            position.trimHistory();
+            token = "moves";
+        }
+    }
+    
+    // a whole number option value, false if TEXT isn't one
+    static bool parseNumber(const std::string& TEXT, int& number) {
+        const char* END = TEXT.data() + TEXT.size();
+        const auto [LAST, ERROR] = std::from_chars(TEXT.data(), END, number);
+        return ERROR == std::errc() && LAST == END;
+    }
+    
+    // setoption name <name> value <value>, names are matched without case. the value is the rest
+    // of the line so a book path can have spaces in it
+    void setOption(std::istringstream& arguments) {
+        std::string token;
+        std::string name;
+        std::string value;
+        arguments >> token;
+        while (arguments >> token && token != "value") {
+            name += (name.empty() ? "" : " ") + token;
+        }
+        std::getline(arguments >> std::ws, value);
+        value.erase(value.find_last_not_of(" \t\r") + 1);
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        
+        // a GUI can send anything, a bad number leaves the option as it was
+        int number = 0;
+        const bool NUMBER = parseNumber(value, number);
+        if ((name == "hash" || name == "threads" || name == "pawn hash") && !NUMBER) {
+            send("info string " + name + " needs a whole number, not " + value);
+        } else if (name == "hash") {
+            table.resize(std::clamp(number, 1, 65536));
+        } else if (name == "threads") {
+            search1.setThreads(std::clamp(number, 1, 256));
+        } else if (name == "pawn hash") {
+            options.pawnHashKB = std::clamp(number, 1, 1048576);
+            search1.setOptions(options);
+        } else if (name == "uci_chess960") {
+            options.chess960 = value == "true";
+            search1.setOptions(options);
+        } else if (name == "ownbook") {
+            ownBook = value == "true";
+        } else if (name == "best book move") {
+            bestBookMove = value == "true";
+        } else if (name == "book file") {
+            if (value.empty() || value == "<empty>") {
+                book.close();
+            } else if (!book.open(value)) {
+                send("info string could not open book " + value);
+            }
+        }
+    }
+    
+    // go [depth d] [nodes n] [movetime ms] [wtime ms] [btime ms] [winc ms] [binc ms] [movestogo n] [infinite]
+    void go(std::istringstream& arguments) {
+        SearchLimits limits;
+        bool infinite = false;
+        int64_t time[2] = { 0, 0 };
+        int64_t increment[2] = { 0, 0 };
+        int64_t movesToGo = 0;
+        std::string token;
+        while (arguments >> token) {
+            if (token == "infinite") {
+                infinite = true;
+            } else if (token == "depth") {
+                arguments >> limits.depth;
+            } else if (token == "nodes") {
+                arguments >> limits.nodes;
+            } else if (token == "movetime") {
+                arguments >> limits.moveTime;
+            } else if (token == "wtime" || token == "btime") {
+                arguments >> time[token == "btime"];
+            } else if (token == "winc" || token == "binc") {
+                arguments >> increment[token == "binc"];
+            } else if (token == "movestogo") {
+                arguments >> movesToGo;
+            }
+        }
+        
+        const int SIDE = position.whiteTurn ? 0 : 1;
+        if (!infinite && !limits.moveTime && time[SIDE] > 0) {
+            const int64_t BUDGET = time[SIDE] / (movesToGo > 0 ? movesToGo : DEFAULT_MOVES_TO_GO) + increment[SIDE] * 3 / 4;
+            limits.moveTime = std::max<int64_t>(1, std::min(BUDGET, time[SIDE] - MOVE_OVERHEAD));
+        }
+        
+        // go infinite has to keep going until stop, so only a timed or limited search takes a book move
+        if (ownBook && !options.chess960 && !infinite) {
+            const Move BOOK_MOVE = book.probe(moves1, position, bestBookMove ? BOOK_BEST : BOOK_WEIGHTED);
+            if (BOOK_MOVE != NULL_MOVE) {
+                send("info string book move\nbestmove " + moveToAlgebraic(BOOK_MOVE));
+                return;
+            }
+        }
+        
+        // cleared here rather than on the search thread so a stop sent right after go isn't lost
+        stopRequested = false;
+        search1.clearStop();
+        searchThread = std::thread([this, limits, infinite] {
+            const Move MOVE = search1.search(limits, position, false);
+            if (infinite) {
+                std::unique_lock<std::mutex> lock(stopMutex);
+                stopCondition.wait(lock, [this] { return stopRequested; });
+            }
+            send("bestmove " + (MOVE == NULL_MOVE ? "0000" : moveToAlgebraic(MOVE, options.chess960)));
+        });
+    }
+    
+    // end the running search, its bestmove is sent before this returns
+    void stopSearch() {
+        if (!searchThread.joinable()) {
+            return;
+        }
+        search1.stop();
+        {
+            std::lock_guard<std::mutex> lock(stopMutex);
+            stopRequested = true;
+        }
+        stopCondition.notify_one();
+        searchThread.join();
+    }
+    
+public:
+    Uci(TranspositionTable& table, const int THREADS, const SearchOptions& OPTIONS, PolyglotBook& book) : table(table),
+        search1(table, THREADS), options(OPTIONS), position(Board::fenToPosition(START_FEN)), book(book) {
+        search1.setOptions(options);
+        search1.setReporter([this](const SearchReport& REPORT) { sendReport(REPORT); });
+    }
+    
+    ~Uci() {
+        stopSearch();
+    }
+    
+    // answer one command, false once it is quit. anything not understood is ignored
+    bool execute(const std::string& LINE) {
+        std::istringstream arguments(LINE);
+        std::string command;
+        arguments >> command;
+        
+        if (command == "uci") {
+            send("id name Chess\nid author Owen Colley\n"
+                "option name Hash type spin default " + std::to_string(table.sizeMB()) + " min 1 max 65536\n"
+                "option name Threads type spin default " + std::to_string(search1.getThreads()) + " min 1 max 256\n"
+                "option name Pawn Hash type spin default " + std::to_string(options.pawnHashKB) + " min 1 max 1048576\n"
+                "option name UCI_Chess960 type check default false\n"
+                "option name OwnBook type check default true\n"
+                "option name Book File type string default <empty>\n"
+                "option name Best Book Move type check default false\nuciok");
+        } else if (command == "isready") {
+            send("readyok");
+        } else if (command == "ucinewgame") {
+            stopSearch();
+            table.clear();
+        } else if (command == "position") {
+            stopSearch();
+            setPosition(arguments);
+        } else if (command == "setoption") {
+            stopSearch();
+            setOption(arguments);
+        } else if (command == "go") {
+            stopSearch();
+            go(arguments);
+        } else if (command == "stop") {
+            stopSearch();
+        } else if (command == "quit") {
+            stopSearch();
+            return false;
+        }
+        return true;
+    }
+    
+    // answer commands until quit or the end of input
+    void loop() {
+        std::string line;
+        while (std::getline(std::cin, line) && execute(line)) {}
+        stopSearch();
+    }
+};
+
+#endif
@@ -0,0 +1,50 @@
+/**
+ * Purpose: Random keys used to build a 64 bit hash that identifies a position
+ * 
+ * Author: Owen Colley
+ * Date: 10/16/26
+ * 
+ */
+
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+#include <stdint.h>
+
+struct ZobristKeys {
+    uint64_t pieces[12][64];
+    uint64_t castles[2][8]; // white and black castle rights, keyed by the file of the castling rook
+    uint64_t enPassant[8];
+    uint64_t blackTurn;
+};
+
+// splitmix64 so the keys are fixed at compile time and the same on every machine
+constexpr uint64_t nextRandom(uint64_t& seed) {
+    uint64_t random = (seed += 0x9E3779B97F4A7C15ULL);
+    random = (random ^ (random >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    random = (random ^ (random >> 27)) * 0x94D049BB133111EBULL;
+    return random ^ (random >> 31);
+}
+
+constexpr ZobristKeys makeZobristKeys() {
+    ZobristKeys keys = {};
+    uint64_t seed = 1070372;
+    for (int piece = 0; piece < 12; ++piece) {
+        for (int square = 0; square < 64; ++square) {
+            keys.pieces[piece][square] = nextRandom(seed);
+        }
+    }
+    for (int color = 0; color < 2; ++color) {
+        for (int file = 0; file < 8; ++file) {
+            keys.castles[color][file] = nextRandom(seed);
+        }
+    }
+    for (int file = 0; file < 8; ++file) {
+        keys.enPassant[file] = nextRandom(seed);
+    }
+    keys.blackTurn = nextRandom(seed);
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST = makeZobristKeys();
+
+#endif